@@ -23,12 +23,42 @@
 #ifndef PLEIONE_CORE_HPP
 #define PLEIONE_CORE_HPP
 
+#include <cstddef>
+
 #include "detail/config.hpp"
 
 /// Main namespace
 PLEIONE_NAMESPACE_BEGIN
 
-template<bool Enable> struct prefetch {};
+/// Expected temporal locality of prefetched data, from none to high
+enum class locality { nta, low, moderate, high };
+
+namespace detail {
+
+template<auto... Members> struct prefetch_members {};
+struct prefetch_object {};
+
+} // namespace detail
+
+/// \brief Prefetching policy of traversal algorithms
+///
+/// For backwards compatibility `prefetch<true>` and `prefetch<false>` are
+/// equivalent to a lookahead of one element and no prefetching respectively.
+/// By default only the hooks of the upcoming elements are prefetched, use
+/// `members` or `object` to prefetch the data the visitor is going to access,
+/// e.g. `prefetch<4>::members<&foo::value>`.
+///
+/// \tparam Depth number of elements to look ahead, 0 disables prefetching
+/// \tparam Locality expected temporal locality of the visited elements
+/// \tparam Write whether the visited elements are going to be modified
+/// \tparam Target what else to prefetch besides the hooks
+template<std::size_t Depth, locality Locality = locality::high, bool Write = false, typename Target = void>
+struct prefetch {
+  /// Also prefetches the given members of the upcoming elements
+  template<auto... Members> using members = prefetch<Depth, Locality, Write, detail::prefetch_members<Members...>>;
+  /// Also prefetches all cache lines spanned by the upcoming elements
+  using object = prefetch<Depth, Locality, Write, detail::prefetch_object>;
+};
 
 PLEIONE_NAMESPACE_END
 
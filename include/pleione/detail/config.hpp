@@ -114,8 +114,10 @@ PLEIONE_NAMESPACE_END
 
 #if defined(__clang__) || defined(__GNUC__)
 #define PLEIONE_PREFETCH(...) __builtin_prefetch((__VA_ARGS__))
+#define PLEIONE_PREFETCH_HINT(address, write, locality) __builtin_prefetch((address), (write), (locality))
 #else
 #define PLEIONE_PREFETCH(...)
+#define PLEIONE_PREFETCH_HINT(address, write, locality)
 #endif
 
 #endif
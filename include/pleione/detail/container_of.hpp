@@ -24,7 +24,10 @@
 #define PLEIONE_DETAIL_CONTAINER_OF_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
+#include <utility>
 
 #include "config.hpp"
 
@@ -32,32 +35,169 @@ PLEIONE_NAMESPACE_BEGIN
 
 namespace detail {
 
+template<typename MemberPointer> struct member_pointer_traits;
+
+template<typename Structure, typename MemberType> struct member_pointer_traits<MemberType Structure::*> {
+  using structure = Structure;
+  using member_type = MemberType;
+};
+
+// Offsets are found at compile time by comparing the address of each byte of
+// the structure with the address of the member, one step of constant
+// evaluation per byte. Members further in are handled at run time.
+constexpr std::ptrdiff_t constant_offset_limit = 4096;
+
+// The scan compares the addresses of different members of a union during
+// constant evaluation. GCC evaluates such comparisons, other compilers may
+// reject them, so there all offsets are computed at run time.
+#if defined(__GNUC__) && !defined(__clang__)
+#define PLEIONE_CONSTANT_OFFSETS 1
+#else
+#define PLEIONE_CONSTANT_OFFSETS 0
+#endif
+
+// Whether an object of the structure may appear in a constant expression, as
+// an inactive union member. Abstract classes cannot be union members at all.
+template<typename Structure>
+inline constexpr bool has_constant_offsets_v =
+    PLEIONE_CONSTANT_OFFSETS && std::is_trivially_destructible_v<Structure> && !std::is_abstract_v<Structure>;
+
+// Storage for an object of the structure that is never constructed. Only the
+// addresses of its members are used.
+template<typename Structure> union offset_storage {
+  char bytes[sizeof(Structure)];
+  Structure object;
+
+  constexpr offset_storage() noexcept : bytes{} {}
+};
+
+// Finds the byte at which the subobject begins. Only pointer comparisons are
+// involved, so this is a constant expression. Returns -1 if the subobject
+// does not begin within constant_offset_limit bytes.
+template<typename Structure, typename Subobject>
+constexpr std::ptrdiff_t constant_offset_of(offset_storage<Structure> const& storage,
+                                            Subobject const& subobject) noexcept {
+  auto address = static_cast<void const*>(&subobject);
+  auto limit = std::ptrdiff_t(sizeof(Structure)) < constant_offset_limit ? std::ptrdiff_t(sizeof(Structure))
+                                                                          : constant_offset_limit;
+  for (auto offset = std::ptrdiff_t(0); offset < limit; ++offset) {
+    if (static_cast<void const*>(storage.bytes + offset) == address) { return offset; }
+  }
+  return -1;
+}
+
+template<typename Structure, auto Member> constexpr std::ptrdiff_t constant_member_offset_of() noexcept {
+  constexpr auto storage = offset_storage<Structure>();
+  using member_type = typename member_pointer_traits<decltype(Member)>::member_type;
+  return constant_offset_of(storage, storage.object.*static_cast<member_type Structure::*>(Member));
+}
+
+template<typename Structure, auto Member>
+inline constexpr std::ptrdiff_t constant_offset_v = constant_member_offset_of<Structure, Member>();
+
+template<typename Structure, typename Base> constexpr std::ptrdiff_t constant_base_offset_of() noexcept {
+  constexpr auto storage = offset_storage<Structure>();
+  return constant_offset_of(storage, *static_cast<Base const*>(&storage.object));
+}
+
+template<typename Structure, typename Base>
+inline constexpr std::ptrdiff_t constant_base_offset_v = constant_base_offset_of<Structure, Base>();
+
+// Both the Itanium and the MSVC C++ ABIs represent a pointer to a data member
+// as the offset of the member: a ptrdiff_t and, for classes without virtual
+// bases, a 32-bit integer, respectively. A type of size 1 never matches the
+// size of a pointer to member.
+#if defined(_MSC_VER)
+using member_pointer_offset = std::int32_t;
+#elif defined(__GNUC__) || defined(__clang__)
+using member_pointer_offset = std::ptrdiff_t;
+#else
+using member_pointer_offset = char;
+#endif
+
+// Suitably aligned storage for an object of the structure, which is never
+// constructed. The structure may be abstract. Used only if the representation
+// of pointers to members is not known.
+template<typename Structure> inline std::aligned_storage_t<sizeof(Structure), alignof(Structure)> offset_object;
+
+template<typename Structure> Structure const* offset_object_address() noexcept {
+  return reinterpret_cast<Structure const*>(&offset_object<Structure>);
+}
+
+template<typename Derived, typename Base, typename = void>
+struct is_virtual_base_of : std::is_base_of<Base, Derived> {};
+
+// A base class can be cast down to a derived one unless it is a virtual base.
+template<typename Derived, typename Base>
+struct is_virtual_base_of<Derived, Base, std::void_t<decltype(static_cast<Derived*>(std::declval<Base*>()))>>
+    : std::false_type {};
+
 /// \brief Returns offset of a member in an object.
 ///
 /// \note Unlike the `offsetof` macro provided by the standard this function
-/// works with pointers to members and non-standard layout types. However, it
-/// needs to take advantage of the ABI properties which may cause portability
-/// problems.
+/// works with pointers to members and non-standard layout types. The offset is
+/// read from the representation of `pointer`, as defined by the Itanium and
+/// MSVC C++ ABIs, so when `pointer` is a constant the computation is folded by
+/// the optimiser, but it is not a constant expression. See
+/// offset_of<Structure, Member>(). With other ABIs, and for MSVC classes with
+/// virtual bases, the offset is the distance between the member of a static,
+/// never constructed, object and the object itself.
 ///
 /// \tparam Structure type of the object
 /// \tparam MemberType type of the member object
 /// \param pointer pointer to the member
 /// \returns offset from the beginning of the object to the member
-template<typename Structure, typename MemberType> ptrdiff_t offset_of(MemberType Structure::*pointer) noexcept {
-#if (defined(__linux__) || defined(__APPLE__)) && defined(__x86_64__)
-  using member_pointer_value_type = ptrdiff_t;
-#elif defined(_WIN32) && (defined(_M_X64) || defined(_M_IX86))
-  using member_pointer_value_type = int32_t;
-#else
-#error Unknown ABI
-#endif
-  static_assert(sizeof(pointer) == sizeof(member_pointer_value_type));
-  union {
-    MemberType Structure::*ptr;
-    member_pointer_value_type off;
-  };
-  ptr = pointer;
-  return off;
+template<typename Structure, typename MemberType> std::ptrdiff_t offset_of(MemberType Structure::*pointer) noexcept {
+  if constexpr (sizeof(pointer) == sizeof(member_pointer_offset)) {
+    auto offset = member_pointer_offset();
+    std::memcpy(&offset, &pointer, sizeof(offset));
+    return std::ptrdiff_t(offset);
+  } else {
+    auto object = offset_object_address<std::remove_const_t<Structure>>();
+    return reinterpret_cast<char const*>(&(object->*pointer)) - reinterpret_cast<char const*>(object);
+  }
+}
+
+/// \brief Returns offset of a member in an object at compile time
+///
+/// With GCC, if `Structure` is trivially destructible, not abstract, and the
+/// member begins within the first constant_offset_limit bytes, the offset is a
+/// constant expression. Otherwise, C++17 does not allow creating an object of
+/// `Structure`, not even an inactive union member, during constant evaluation,
+/// and offset_of(Member) is used instead.
+///
+/// \tparam Structure type of the object, may be a class derived from the one
+/// `Member` belongs to
+/// \tparam Member pointer to the member
+/// \returns offset from the beginning of the object to the member
+template<typename Structure, auto Member> constexpr std::ptrdiff_t offset_of() noexcept {
+  using structure = std::remove_const_t<Structure>;
+  if constexpr (has_constant_offsets_v<structure>) {
+    if constexpr (constant_offset_v<structure, Member> >= 0) { return constant_offset_v<structure, Member>; }
+  }
+  return offset_of(static_cast<typename member_pointer_traits<decltype(Member)>::member_type structure::*>(Member));
+}
+
+/// \brief Returns offset of a base class subobject in an object
+///
+/// Like offset_of<Structure, Member>() the offset is a constant expression
+/// with GCC if `Structure` is trivially destructible, not abstract, and the
+/// base begins within the first constant_offset_limit bytes. Otherwise, it is
+/// the distance between the base subobject of a static, never constructed,
+/// object and the object itself.
+///
+/// \tparam Structure type of the object
+/// \tparam Base unambiguous non-virtual base class of `Structure`
+/// \returns offset from the beginning of the object to the base subobject
+template<typename Structure, typename Base> constexpr std::ptrdiff_t base_offset_of() noexcept {
+  using structure = std::remove_const_t<Structure>;
+  static_assert(!is_virtual_base_of<structure, Base>::value,
+                "the offset of a virtual base depends on the dynamic type of the object");
+  if constexpr (has_constant_offsets_v<structure>) {
+    if constexpr (constant_base_offset_v<structure, Base> >= 0) { return constant_base_offset_v<structure, Base>; }
+  }
+  auto object = offset_object_address<structure>();
+  return reinterpret_cast<char const*>(static_cast<Base const*>(object)) - reinterpret_cast<char const*>(object);
 }
 
 /// \brief Returns reference to a object containing given one
@@ -80,6 +220,27 @@ Structure& container_of(MemberType Structure::*member_pointer, MemberType& membe
   return *reinterpret_cast<Structure*>(ptr);
 }
 
+/// \brief Returns reference to a object containing given one
+///
+/// Like container_of(member_pointer, member), but the offset is computed at
+/// compile time with offset_of<Structure, Member>(), so that the result is a
+/// single subtraction of a constant.
+///
+/// \tparam Structure type of the container object
+/// \tparam Member pointer to the member
+/// \param member reference to the member object
+/// \returns reference to the container object
+template<typename Structure, auto Member, typename MemberType> Structure& container_of(MemberType& member) noexcept {
+  using structure = std::remove_const_t<Structure>;
+  auto ptr = reinterpret_cast<char*>(const_cast<std::remove_const_t<MemberType>*>(&member));
+  if constexpr (has_constant_offsets_v<structure>) {
+    if constexpr (constant_offset_v<structure, Member> >= 0) {
+      return *reinterpret_cast<Structure*>(ptr - constant_offset_v<structure, Member>);
+    }
+  }
+  return *reinterpret_cast<Structure*>(ptr - offset_of<Structure, Member>());
+}
+
 } // namespace detail
 
 PLEIONE_NAMESPACE_END
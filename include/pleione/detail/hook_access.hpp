@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_DETAIL_HOOK_ACCESS_HPP
+#define PLEIONE_DETAIL_HOOK_ACCESS_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "config.hpp"
+#include "container_of.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+template<template<typename, typename> typename BaseHook, typename Tag, typename Links>
+BaseHook<Tag, Links>& base_hook_of(BaseHook<Tag, Links>& hook) noexcept;
+
+// Hooks derived from the basic ones, e.g. relocatable_list_hook, name the type
+// the containers link through as hook_type.
+template<typename Hook, typename = void> struct hook_type_of {
+  using type = Hook;
+};
+
+template<typename Hook> struct hook_type_of<Hook, std::void_t<typename Hook::hook_type>> {
+  using type = typename Hook::hook_type;
+};
+
+// Hooks that need to know whether they are linked declare safe_link, and the
+// containers reset them when their elements are erased.
+template<typename Hook, typename = void> struct is_safe_link : std::false_type {};
+
+template<typename Hook> struct is_safe_link<Hook, std::enable_if_t<Hook::safe_link>> : std::true_type {};
+
+// Hooks that unlink themselves declare auto_unlink, and can only be used by
+// containers that do not track anything besides the links.
+template<typename Hook, typename = void> struct is_auto_unlink : std::false_type {};
+
+template<typename Hook> struct is_auto_unlink<Hook, std::enable_if_t<Hook::auto_unlink>> : std::true_type {};
+
+/// \brief Conversions between elements of an intrusive container and hooks
+///
+/// \tparam T type of the elements
+/// \tparam Hook pointer to the hook member of T or, for hooks T inherits from
+/// `BaseHook<Tag, Links>`, intrusive::base_hook<Tag>
+/// \tparam BaseHook template of the base class hooks of the container
+template<typename T, auto Hook, template<typename, typename> typename BaseHook, typename = decltype(Hook)>
+struct hook_access;
+
+template<typename T, auto Hook, template<typename, typename> typename BaseHook, typename Structure,
+         typename MemberType>
+struct hook_access<T, Hook, BaseHook, MemberType Structure::*> {
+  using hook_type = typename hook_type_of<MemberType>::type;
+
+  static constexpr bool safe_link = is_safe_link<MemberType>::value;
+  static constexpr bool auto_unlink = is_auto_unlink<MemberType>::value;
+
+  static hook_type& hook(T& object) noexcept { return object.*Hook; }
+  static hook_type const& hook(T const& object) noexcept { return object.*Hook; }
+
+  template<typename Object, typename HookType> static Object& object(HookType& hook) noexcept {
+    using member = std::conditional_t<std::is_const_v<HookType>, MemberType const, MemberType>;
+    return container_of<Object, Hook>(static_cast<member&>(hook));
+  }
+
+  static constexpr std::ptrdiff_t offset() noexcept {
+    return offset_of<T, Hook>() + base_offset_of<MemberType, hook_type>();
+  }
+};
+
+// The conversions are static_casts, with constant offsets that are zero for
+// the first base class.
+template<typename T, auto Hook, template<typename, typename> typename BaseHook, typename Tag>
+struct hook_access<T, Hook, BaseHook, Tag*> {
+  using base_type = std::remove_reference_t<decltype(base_hook_of<BaseHook, Tag>(std::declval<T&>()))>;
+  using hook_type = typename base_type::hook_type;
+
+  static constexpr bool safe_link = false;
+  static constexpr bool auto_unlink = false;
+
+  static hook_type& hook(T& object) noexcept { return static_cast<base_type&>(object); }
+  static hook_type const& hook(T const& object) noexcept { return static_cast<base_type const&>(object); }
+
+  template<typename Object, typename HookType> static Object& object(HookType& hook) noexcept {
+    using base = std::conditional_t<std::is_const_v<HookType>, base_type const, base_type>;
+    return static_cast<Object&>(static_cast<base&>(hook));
+  }
+
+  static constexpr std::ptrdiff_t offset() noexcept {
+    return base_offset_of<T, base_type>() + base_offset_of<base_type, hook_type>();
+  }
+};
+
+} // namespace detail
+
+PLEIONE_NAMESPACE_END
+
+#endif
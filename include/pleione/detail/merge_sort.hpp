@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_DETAIL_MERGE_SORT_HPP
+#define PLEIONE_DETAIL_MERGE_SORT_HPP
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "config.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+/// \brief Merges two sorted null-terminated chains of nodes
+///
+/// The merge is stable: if elements compare equal the one from `a` comes
+/// first.
+///
+/// \param a first sorted chain
+/// \param b second sorted chain
+/// \param next_of function returning a reference to the next pointer of a node,
+/// which may be any pointer-like link convertible from and to `Node*`
+/// \param less comparison function
+/// \returns head of the merged chain
+template<typename Node, typename NextOf, typename Less>
+Node* merge_chains(Node* a, Node* b, NextOf& next_of, Less& less) {
+  std::remove_reference_t<decltype(next_of(a))> head = nullptr;
+  auto tail = &head;
+  while (a && b) {
+    if (less(*b, *a)) {
+      *tail = b;
+      tail = &next_of(b);
+      b = *tail;
+      if (b) { PLEIONE_PREFETCH(next_of(b)); }
+    } else {
+      *tail = a;
+      tail = &next_of(a);
+      a = *tail;
+      if (a) { PLEIONE_PREFETCH(next_of(a)); }
+    }
+  }
+  *tail = a ? a : b;
+  return head;
+}
+
+/// \brief Sorts a null-terminated singly-linked chain of nodes
+///
+/// This is a stable bottom-up merge sort. Pending runs are kept in a fixed
+/// array of bins, bin `i` holding a sorted run of `2^i` nodes, so the sort
+/// does not allocate and uses a bounded amount of stack.
+///
+/// \param head first node of the chain
+/// \param next_of function returning a reference to the next pointer of a node
+/// \param less comparison function
+/// \returns head of the sorted chain
+template<typename Node, typename NextOf, typename Less> Node* merge_sort(Node* head, NextOf next_of, Less less) {
+  Node* bins[std::numeric_limits<std::size_t>::digits] = {};
+  auto bin_count = std::size_t(0);
+  while (head) {
+    auto carry = head;
+    head = next_of(head);
+    PLEIONE_PREFETCH(head);
+    next_of(carry) = nullptr;
+    auto i = std::size_t(0);
+    for (; bins[i]; ++i) {
+      carry = merge_chains(bins[i], carry, next_of, less);
+      bins[i] = nullptr;
+    }
+    bins[i] = carry;
+    if (i >= bin_count) { bin_count = i + 1; }
+  }
+
+  Node* result = nullptr;
+  for (auto i = std::size_t(0); i < bin_count; ++i) {
+    if (bins[i]) { result = result ? merge_chains(bins[i], result, next_of, less) : bins[i]; }
+  }
+  return result;
+}
+
+} // namespace detail
+
+PLEIONE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_DETAIL_PARALLEL_HPP
+#define PLEIONE_DETAIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+/// Number of elements between consecutive candidate split points.
+constexpr std::size_t parallel_split_stride = 256;
+
+/// \brief Splits a range into segments of similar length
+///
+/// The range is walked once and every `parallel_split_stride`-th iterator is
+/// recorded as a candidate split point, so the length of the range does not
+/// need to be known in advance.
+///
+/// \param threads number of threads, 0 means one per hardware thread
+/// \param first beginning of the range
+/// \param last end of the range
+/// \returns boundaries of the non-empty segments, starting with `first` and
+/// ending with `last`
+template<typename Iterator> std::vector<Iterator> split_segments(unsigned threads, Iterator first, Iterator last) {
+  if (!threads) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+  auto candidates = std::vector<Iterator>();
+  for (auto n = std::size_t(0); first != last; ++n) {
+    first.prefetch_next();
+    if (n % parallel_split_stride == 0) { candidates.emplace_back(first); }
+    ++first;
+  }
+
+  auto segments = std::min(std::size_t(threads), candidates.size());
+  auto boundaries = std::vector<Iterator>();
+  boundaries.reserve(segments + 1);
+  for (auto i = std::size_t(0); i < segments; ++i) {
+    boundaries.emplace_back(candidates[i * candidates.size() / segments]);
+  }
+  boundaries.emplace_back(last);
+  return boundaries;
+}
+
+// Owns threads and joins them when it goes out of scope, also when the stack
+// is unwound.
+class thread_joiner {
+  std::vector<std::thread> threads_;
+
+public:
+  explicit thread_joiner(std::size_t n) { threads_.reserve(n); }
+  thread_joiner(thread_joiner const&) = delete;
+  thread_joiner& operator=(thread_joiner const&) = delete;
+  ~thread_joiner() {
+    for (auto& thread : threads_) {
+      if (thread.joinable()) { thread.join(); }
+    }
+  }
+
+  template<typename Function> void spawn(Function&& fn) { threads_.emplace_back(std::forward<Function>(fn)); }
+};
+
+/// \brief Invokes a function on each segment, each in its own thread
+///
+/// The first segment is processed by the calling thread. All threads are
+/// joined before this function returns or throws. If a thread cannot be
+/// started that exception is propagated. Otherwise, if any invocation of `fn`
+/// throws, the exception thrown for the earliest segment is rethrown.
+///
+/// \param boundaries boundaries of the segments as returned by split_segments()
+/// \param fn function taking the index of the segment, its beginning and end
+template<typename Iterator, typename Function>
+void run_segments(std::vector<Iterator> const& boundaries, Function&& fn) {
+  if (boundaries.size() < 2) { return; }
+  auto errors = std::vector<std::exception_ptr>(boundaries.size() - 1);
+  auto run = [&](std::size_t idx) {
+    try {
+      fn(idx, boundaries[idx], boundaries[idx + 1]);
+    } catch (...) {
+      errors[idx] = std::current_exception();
+    }
+  };
+  {
+    auto threads = thread_joiner(boundaries.size() - 2);
+    for (auto i = std::size_t(1); i + 1 < boundaries.size(); ++i) {
+      threads.spawn([&run, i] { run(i); });
+    }
+    run(0);
+  }
+  for (auto& error : errors) {
+    if (error) { std::rethrow_exception(error); }
+  }
+}
+
+} // namespace detail
+
+PLEIONE_NAMESPACE_END
+
+#endif
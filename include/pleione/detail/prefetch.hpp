@@ -0,0 +1,130 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_DETAIL_PREFETCH_HPP
+#define PLEIONE_DETAIL_PREFETCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../core.hpp"
+
+#include "container_of.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+constexpr std::size_t cache_line_size = 64;
+
+template<locality Locality, bool Write, typename Structure, auto... Members>
+void prefetch_target(std::uintptr_t object, prefetch_members<Members...>*) noexcept {
+  (PLEIONE_PREFETCH_HINT(reinterpret_cast<void const*>(object + std::uintptr_t(offset_of<Structure, Members>())),
+                         Write, int(Locality)),
+   ...);
+}
+
+template<locality Locality, bool Write, typename Structure>
+void prefetch_target(std::uintptr_t object, prefetch_object*) noexcept {
+  for (auto line = object & ~(cache_line_size - 1); line < object + sizeof(Structure); line += cache_line_size) {
+    PLEIONE_PREFETCH_HINT(reinterpret_cast<void const*>(line), Write, int(Locality));
+  }
+}
+
+/// \brief Prefetches a hook and, depending on `Target`, its element
+///
+/// The address of the element is computed with integer arithmetic, so `hook`
+/// may point to a list root or be null, in which case the prefetches are
+/// harmless. The hook need not be a member of the element, e.g. it may be a
+/// base class subobject.
+///
+/// \tparam Target nothing (`void`), `prefetch_members` or `prefetch_object`
+/// \tparam Structure type of the element
+/// \param offset offset of the hook in the element
+/// \param hook hook to prefetch
+template<locality Locality, bool Write, typename Target, typename Structure>
+void prefetch_element(std::ptrdiff_t offset, void const* hook) noexcept {
+  PLEIONE_PREFETCH_HINT(hook, Write, int(Locality));
+  if constexpr (!std::is_void_v<Target>) {
+    auto object = reinterpret_cast<std::uintptr_t>(hook) - std::uintptr_t(offset);
+    prefetch_target<Locality, Write, Structure>(object, static_cast<Target*>(nullptr));
+  }
+}
+
+/// \brief Finds the first element satisfying a predicate, prefetching ahead
+///
+/// With `Depth` of 0 or 1 the iterator is advanced before `pred` is invoked,
+/// so `pred` may unlink the element it is given. With a larger `Depth` the
+/// traversal keeps a ring of the next `Depth` iterators. Each time an element
+/// is consumed the ring is refilled with the following one, and the element
+/// after that is prefetched, so that the work done by `pred` on the elements
+/// in the ring overlaps with the cache misses of walking the list.
+///
+/// \warning Since the traversal runs ahead of `pred`, `pred` must not unlink
+/// any of the following `Depth` elements.
+///
+/// \tparam Depth number of elements to look ahead
+/// \param first beginning of the range
+/// \param last end of the range
+/// \param pred predicate taking an iterator
+/// \returns iterator to the first element for which `pred` returned true, or
+/// `last` if there is none
+template<std::size_t Depth, locality Locality, bool Write, typename Target, typename Iterator, typename Predicate>
+Iterator prefetching_find(Iterator first, Iterator last, Predicate&& pred) {
+  if constexpr (Depth < 2) {
+    while (first != last) {
+      if constexpr (Depth == 1) { first.template prefetch_next<Locality, Write, Target>(); }
+      auto current = first++;
+      if (pred(current)) { return current; }
+    }
+    return last;
+  } else {
+    Iterator ring[Depth];
+    auto count = std::size_t(0);
+    for (; count < Depth && first != last; ++count) {
+      first.template prefetch_next<Locality, Write, Target>();
+      ring[count] = first++;
+    }
+
+    auto idx = std::size_t(0);
+    while (first != last) {
+      auto current = ring[idx];
+      first.template prefetch_next<Locality, Write, Target>();
+      ring[idx] = first++;
+      idx = idx + 1 == Depth ? 0 : idx + 1;
+      if (pred(current)) { return current; }
+    }
+
+    for (; count; --count) {
+      if (pred(ring[idx])) { return ring[idx]; }
+      idx = idx + 1 == Depth ? 0 : idx + 1;
+    }
+    return last;
+  }
+}
+
+} // namespace detail
+
+PLEIONE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_DETAIL_RELOCATE_HPP
+#define PLEIONE_DETAIL_RELOCATE_HPP
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+/// \brief Relocates an object to a new address
+///
+/// The object is move-constructed at the destination and the original is
+/// destroyed, but its storage is not released.
+///
+/// \note Intrusive hooks are not movable, so for an object that contains one
+/// `T` needs a move constructor that leaves the hook out.
+///
+/// \param from object to relocate
+/// \param to uninitialised storage suitable for an object of type `T`
+/// \returns reference to the relocated object
+template<typename T> T& relocate(T& from, void* to) noexcept {
+  static_assert(std::is_nothrow_move_constructible_v<T>, "relocate() requires a nothrow move constructor");
+  static_assert(std::is_nothrow_destructible_v<T>);
+  auto& object = *::new (to) T(std::move(from));
+  from.~T();
+  return object;
+}
+
+} // namespace detail
+
+PLEIONE_NAMESPACE_END
+
+#endif
@@ -25,6 +25,15 @@
 
 #include "core.hpp"
 #include "forward_list.hpp"
+#include "hlist.hpp"
+#include "interleaved.hpp"
+#include "lazy_checkpoint_index.hpp"
+#include "links.hpp"
 #include "list.hpp"
+#include "lockstep.hpp"
+#include "set.hpp"
+#include "side_list.hpp"
+#include "unordered_set.hpp"
+#include "xor_list.hpp"
 
 #endif
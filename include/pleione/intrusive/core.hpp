@@ -28,7 +28,17 @@
 PLEIONE_NAMESPACE_BEGIN
 
 /// Intrusive containers
-namespace intrusive {} // namespace intrusive
+namespace intrusive {
+
+/// \brief Selects a base class hook instead of a member one
+///
+/// Passed as the `Hook` parameter of a container, e.g.
+/// `list<conn, base_hook<by_lru>>`, makes the container use the hook the
+/// element inherits from the container's base hook template with tag `Tag`,
+/// such as `list_base_hook<by_lru>`. The tag may be an incomplete type.
+template<typename Tag> inline constexpr Tag* base_hook = nullptr;
+
+} // namespace intrusive
 
 PLEIONE_NAMESPACE_END
 
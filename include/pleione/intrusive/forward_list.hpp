@@ -24,31 +24,119 @@
 #define PLEIONE_INTRUSIVE_FORWARD_LIST_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
 
 #include "core.hpp"
+#include "links.hpp"
 
 #include "../detail/container_of.hpp"
+#include "../detail/hook_access.hpp"
+#include "../detail/merge_sort.hpp"
+#include "../detail/prefetch.hpp"
+#include "../detail/relocate.hpp"
 
 PLEIONE_NAMESPACE_BEGIN
 
 namespace intrusive {
 
-class forward_list_hook {
-  forward_list_hook* next_;
+/// \brief Hook of intrusive::forward_list
+///
+/// \tparam Links representation of the links: pointer_links, arena_links or
+/// relative_links
+template<typename Links = pointer_links> class basic_forward_list_hook {
+public:
+  /// Representation of a link to another hook.
+  using pointer = typename Links::template pointer<basic_forward_list_hook>;
+
+private:
+  pointer next_;
 
 private:
-  explicit forward_list_hook(forward_list_hook* next) noexcept : next_(next) {}
+  explicit basic_forward_list_hook(basic_forward_list_hook* next) noexcept : next_(next) {}
 
-  template<typename T, forward_list_hook T::*> friend class forward_list;
+  template<typename T, auto, bool> friend class forward_list;
+  friend class relocatable_forward_list_hook;
 
 public:
-  forward_list_hook() = default;
-  forward_list_hook(forward_list_hook const&) = delete;
-  forward_list_hook(forward_list_hook&&) = delete;
+  basic_forward_list_hook() = default;
+  basic_forward_list_hook(basic_forward_list_hook const&) = delete;
+  basic_forward_list_hook(basic_forward_list_hook&&) = delete;
 };
 
-template<typename T, forward_list_hook T::*Hook> class forward_list {
-  forward_list_hook root_{nullptr};
+using forward_list_hook = basic_forward_list_hook<>;
+
+/// Hook storing a 32-bit offset from the base of `Arena`, see arena_links.
+template<typename Arena> using compact_forward_list_hook = basic_forward_list_hook<arena_links<Arena>>;
+/// Hook storing an offset from itself, usable in shared memory, see relative_links.
+using offset_forward_list_hook = basic_forward_list_hook<relative_links>;
+
+/// \brief Base class hook of intrusive::forward_list
+///
+/// An element may inherit several base hooks with different tags and be linked
+/// through each of them, e.g. into `forward_list<conn, base_hook<by_owner>>`.
+///
+/// \tparam Tag type distinguishing the base hooks of an element
+/// \tparam Links representation of the links
+template<typename Tag, typename Links = pointer_links>
+class forward_list_base_hook : public basic_forward_list_hook<Links> {
+public:
+  using hook_type = basic_forward_list_hook<Links>;
+};
+
+/// \brief Hook of intrusive::forward_list that can be moved with its element
+///
+/// A hook cannot reach the one linking to it, so moving it just copies the
+/// link. After elements have been moved, e.g. by a growing `std::vector`, each
+/// list linking them has to be repaired with forward_list::relink_after_move().
+class relocatable_forward_list_hook : public forward_list_hook {
+public:
+  using hook_type = forward_list_hook;
+
+  relocatable_forward_list_hook() noexcept : forward_list_hook(nullptr) {}
+  relocatable_forward_list_hook(relocatable_forward_list_hook&& other) noexcept : forward_list_hook(other.next_) {}
+
+  relocatable_forward_list_hook& operator=(relocatable_forward_list_hook&& other) noexcept {
+    next_ = other.next_;
+    return *this;
+  }
+};
+
+} // namespace intrusive
+
+namespace detail {
+
+template<bool TrackTail, typename Hook> struct forward_list_tail {};
+
+template<typename Hook> struct forward_list_tail<true, Hook> {
+  typename Hook::pointer last_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+} // namespace detail
+
+namespace intrusive {
+
+/// \brief Intrusive singly-linked list
+///
+/// By default the list head is a single pointer. If `TrackTail` is set the
+/// list also keeps a pointer to its last element and the number of elements,
+/// which makes push_back(), back(), size() and splicing a whole list
+/// constant time at the cost of counting the elements of erased and spliced
+/// ranges.
+///
+/// \tparam T type of the elements
+/// \tparam Hook pointer to the basic_forward_list_hook member of T, or
+/// base_hook<Tag> if T inherits from forward_list_base_hook<Tag>
+/// \tparam TrackTail whether to track the last element and the size
+template<typename T, auto Hook, bool TrackTail = false>
+class forward_list
+    : detail::forward_list_tail<TrackTail, typename detail::hook_access<T, Hook, forward_list_base_hook>::hook_type> {
+  using access = detail::hook_access<T, Hook, forward_list_base_hook>;
+  using hook_type = typename access::hook_type;
+
+  hook_type root_{nullptr};
 
 public:
   using value_type = T;
@@ -61,7 +149,8 @@ public:
 
 public:
   template<bool Constant> class basic_iterator {
-    using hook_type = std::conditional_t<Constant, forward_list_hook const, forward_list_hook>;
+    using hook_type = std::conditional_t<Constant, typename forward_list::hook_type const,
+                                         typename forward_list::hook_type>;
     hook_type* current_ = nullptr;
 
   private:
@@ -80,8 +169,8 @@ public:
 
     operator basic_iterator<true>() const noexcept { return basic_iterator<true>(current_); }
 
-    reference operator*() const noexcept { return detail::container_of<value_type, hook_type>(Hook, *current_); }
-    pointer operator->() const noexcept { return &detail::container_of<value_type, hook_type>(Hook, *current_); }
+    reference operator*() const noexcept { return access::template object<value_type>(*current_); }
+    pointer operator->() const noexcept { return &access::template object<value_type>(*current_); }
 
     basic_iterator& operator++() noexcept {
       current_ = current_->next_;
@@ -96,15 +185,54 @@ public:
     bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
     bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
 
-    void prefetch_next() const noexcept { PLEIONE_PREFETCH(current_->next_); }
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_next() const noexcept {
+      detail::prefetch_element<Locality, Write, Target, T>(access::offset(),
+                                                           static_cast<hook_type const*>(current_->next_));
+    }
   };
 
 public:
   using iterator = basic_iterator<false>;
   using const_iterator = basic_iterator<true>;
 
+private:
+  void reset_tail() noexcept {
+    if constexpr (TrackTail) {
+      this->last_ = &root_;
+      this->size_ = 0;
+    }
+  }
+
+  // Records that n elements ending with last were linked after position.
+  void linked_after(hook_type* position, hook_type* last, size_type n) noexcept {
+    if constexpr (TrackTail) {
+      if (position == this->last_) { this->last_ = last; }
+      this->size_ += n;
+    }
+  }
+
+  // Records that n elements ending with last were unlinked from after position.
+  void unlinked_after(hook_type* position, hook_type* last, size_type n) noexcept {
+    if constexpr (TrackTail) {
+      if (last == this->last_) { this->last_ = position; }
+      this->size_ -= n;
+    }
+  }
+
+  // Moves the elements of other, which is left empty.
+  void take(forward_list& other) noexcept {
+    root_.next_ = other.root_.next_;
+    if constexpr (TrackTail) {
+      this->last_ = other.empty() ? &root_ : static_cast<hook_type*>(other.last_);
+      this->size_ = other.size_;
+    }
+    other.root_.next_ = nullptr;
+    other.reset_tail();
+  }
+
 public:
-  forward_list() = default;
+  forward_list() noexcept { reset_tail(); }
 
   template<typename ForwardIt> forward_list(ForwardIt first, ForwardIt last) noexcept {
     static_assert(
@@ -113,29 +241,45 @@ public:
   }
 
   forward_list(forward_list const&) = delete;
-  forward_list(forward_list&& other) noexcept { root_.next_ = other.root_.next_; }
+  forward_list(forward_list&& other) noexcept { take(other); }
 
   forward_list& operator=(forward_list const&) = delete;
   forward_list& operator=(forward_list&& other) noexcept {
-    root_.next_ = other.root_.next_;
+    if (PLEIONE_UNLIKELY(this == &other)) { return *this; }
+    take(other);
     return *this;
   }
 
   template<typename ForwardIt> void assign(ForwardIt first, ForwardIt last) noexcept {
     static_assert(
         std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    reset_tail();
     auto prev = &root_;
+    auto n = size_type(0);
     using std::for_each;
     for_each(first, last, [&](T& object) {
-      auto& hook = object.*Hook;
+      auto& hook = access::hook(object);
       prev->next_ = &hook;
       prev = &hook;
+      ++n;
     });
     prev->next_ = nullptr;
+    linked_after(&root_, prev, n);
   }
 
-  T& front() noexcept { return detail::container_of<T, forward_list_hook>(Hook, *root_.next_); }
-  T const& front() const noexcept { return detail::container_of<T, forward_list_hook>(Hook, *root_.next_); }
+  T& front() noexcept { return access::template object<T>(*root_.next_); }
+  T const& front() const noexcept { return access::template object<T>(*root_.next_); }
+
+  T& back() noexcept {
+    static_assert(TrackTail, "back() requires a forward_list that tracks its tail");
+    PLEIONE_ASSERT(root_.next_);
+    return access::template object<T>(*this->last_);
+  }
+  T const& back() const noexcept {
+    static_assert(TrackTail, "back() requires a forward_list that tracks its tail");
+    PLEIONE_ASSERT(root_.next_);
+    return access::template object<T>(*this->last_);
+  }
 
   iterator before_begin() noexcept { return iterator(&root_); }
   const_iterator before_begin() const noexcept { return const_iterator(&root_); }
@@ -144,37 +288,85 @@ public:
   iterator end() noexcept { return iterator(nullptr); }
   const_iterator end() const noexcept { return const_iterator(nullptr); }
 
+  /// Returns an iterator to an element of the list.
+  iterator iterator_to(T& object) noexcept { return s_iterator_to(object); }
+  const_iterator iterator_to(T const& object) const noexcept { return s_iterator_to(object); }
+  /// Returns an iterator to an element of any list of this type.
+  static iterator s_iterator_to(T& object) noexcept { return iterator(&access::hook(object)); }
+  static const_iterator s_iterator_to(T const& object) noexcept { return const_iterator(&access::hook(object)); }
+
+  /// \brief Returns an iterator to the element preceding position
+  ///
+  /// The list is walked from its beginning, so this takes linear time. To
+  /// erase elements in constant time keep the iterators preceding them, e.g.
+  /// by visiting the list with erase_after().
+  ///
+  /// \param position iterator to an element or end()
+  /// \returns iterator to the preceding element, or before_begin()
+  iterator previous(const_iterator position) noexcept {
+    auto hook = &root_;
+    while (static_cast<hook_type const*>(hook->next_) != position.current_) { hook = hook->next_; }
+    return iterator(hook);
+  }
+  const_iterator previous(const_iterator position) const noexcept {
+    return const_cast<forward_list&>(*this).previous(position);
+  }
+
+  /// Returns an iterator to the last element, or before_begin() if the list is empty.
+  iterator last() noexcept {
+    static_assert(TrackTail, "last() requires a forward_list that tracks its tail");
+    return iterator(this->last_);
+  }
+  const_iterator last() const noexcept {
+    static_assert(TrackTail, "last() requires a forward_list that tracks its tail");
+    return const_iterator(this->last_);
+  }
+
   bool empty() const noexcept { return !root_.next_; }
 
-  void clear() noexcept { root_.next_ = nullptr; }
+  size_type size() const noexcept {
+    static_assert(TrackTail, "size() requires a forward_list that tracks its tail");
+    return this->size_;
+  }
+
+  void clear() noexcept {
+    root_.next_ = nullptr;
+    reset_tail();
+  }
 
   iterator insert_after(iterator position, T& object) noexcept {
     PLEIONE_ASSERT(position.current_);
-    auto& hook = object.*Hook;
+    auto& hook = access::hook(object);
     hook.next_ = position.current_->next_;
     position.current_->next_ = &hook;
+    linked_after(position.current_, &hook, 1);
     return iterator(&hook);
   }
 
   template<typename ForwardIt> iterator insert_after(iterator position, ForwardIt first, ForwardIt last) noexcept {
     PLEIONE_ASSERT(position.current_);
     auto prev = position.current_;
-    auto after = position.current_->next_;
+    hook_type* after = position.current_->next_;
+    auto n = size_type(0);
     using std::for_each;
     for_each(first, last, [&](T& object) {
-      auto& hook = object.*Hook;
+      auto& hook = access::hook(object);
       prev->next_ = &hook;
       prev = &hook;
+      ++n;
     });
     prev->next_ = after;
+    linked_after(position.current_, prev, n);
     return iterator(prev);
   }
 
   iterator erase_after(iterator position) noexcept {
     PLEIONE_ASSERT(position.current_);
     PLEIONE_ASSERT(root_.next_);
-    auto after = position.current_->next_->next_;
+    hook_type* erased = position.current_->next_;
+    hook_type* after = erased->next_;
     position.current_->next_ = after;
+    unlinked_after(position.current_, erased, 1);
     return iterator(after);
   }
 
@@ -182,39 +374,75 @@ public:
     if (PLEIONE_UNLIKELY(first == last || std::next(first) == last)) { return last; }
     PLEIONE_ASSERT(first.current_);
     PLEIONE_ASSERT(root_.next_);
+    if constexpr (TrackTail) {
+      auto n = size_type(1);
+      hook_type* last_element = first.current_->next_;
+      while (last_element->next_ != last.current_) {
+        last_element = last_element->next_;
+        ++n;
+      }
+      unlinked_after(first.current_, last_element, n);
+    }
     first.current_->next_ = last.current_;
     return iterator(last.current_);
   }
 
   void push_front(T& object) noexcept {
-    auto& hook = object.*Hook;
+    auto& hook = access::hook(object);
     hook.next_ = root_.next_;
     root_.next_ = &hook;
+    linked_after(&root_, &hook, 1);
+  }
+
+  void push_back(T& object) noexcept {
+    static_assert(TrackTail, "push_back() requires a forward_list that tracks its tail");
+    auto& hook = access::hook(object);
+    hook.next_ = nullptr;
+    this->last_->next_ = &hook;
+    this->last_ = &hook;
+    this->size_++;
   }
 
   void pop_front() noexcept {
     PLEIONE_ASSERT(root_.next_);
-    root_.next_ = root_.next_->next_;
+    hook_type* erased = root_.next_;
+    root_.next_ = erased->next_;
+    unlinked_after(&root_, erased, 1);
   }
 
   void splice_after(iterator position, forward_list& other) noexcept {
     PLEIONE_ASSERT(position.current_);
-    if (position.current_->next_) {
-      auto other_it = other.before_begin();
-      while (std::next(other_it) != other.end()) { other_it = std::next(other_it); }
-      other_it.current_->next_ = position.current_->next_;
+    if constexpr (TrackTail) {
+      if (PLEIONE_UNLIKELY(other.empty())) { return; }
+      other.last_->next_ = position.current_->next_;
+      position.current_->next_ = other.root_.next_;
+      linked_after(position.current_, other.last_, other.size_);
+      other.clear();
+    } else {
+      if (position.current_->next_) {
+        auto other_it = other.before_begin();
+        while (std::next(other_it) != other.end()) { other_it = std::next(other_it); }
+        other_it.current_->next_ = position.current_->next_;
+      }
+      position.current_->next_ = other.root_.next_;
+      other.root_.next_ = nullptr;
     }
-    position.current_->next_ = other.root_.next_;
-    other.root_.next_ = nullptr;
   }
   void splice_after(iterator position, forward_list&& other) noexcept {
     PLEIONE_ASSERT(position.current_);
-    if (position.current_->next_) {
-      auto other_it = other.before_begin();
-      while (std::next(other_it) != other.end()) { other_it = std::next(other_it); }
-      other_it.current_->next_ = position.current_->next_;
+    if constexpr (TrackTail) {
+      if (PLEIONE_UNLIKELY(other.empty())) { return; }
+      other.last_->next_ = position.current_->next_;
+      position.current_->next_ = other.root_.next_;
+      linked_after(position.current_, other.last_, other.size_);
+    } else {
+      if (position.current_->next_) {
+        auto other_it = other.before_begin();
+        while (std::next(other_it) != other.end()) { other_it = std::next(other_it); }
+        other_it.current_->next_ = position.current_->next_;
+      }
+      position.current_->next_ = other.root_.next_;
     }
-    position.current_->next_ = other.root_.next_;
   }
 
   void splice_after(iterator position, forward_list& other, iterator element) noexcept {
@@ -226,37 +454,203 @@ public:
     insert_after(position, *std::next(element));
   }
 
-  void splice_after(iterator position, forward_list&, iterator first, iterator last) noexcept {
+  void splice_after(iterator position, forward_list& other, iterator first, iterator last) noexcept {
     if (PLEIONE_UNLIKELY(first == last || std::next(first) == last)) { return; }
-    auto first_element = first.current_->next_;
+    hook_type* first_element = first.current_->next_;
     auto last_element = first_element;
-    while (last_element->next_ != last.current_) { last_element = last_element->next_; }
+    auto n = size_type(1);
+    while (last_element->next_ != last.current_) {
+      last_element = last_element->next_;
+      ++n;
+    }
+    other.unlinked_after(first.current_, last_element, n);
     last_element->next_ = position.current_->next_;
     position.current_->next_ = first_element;
     first.current_->next_ = last.current_;
+    linked_after(position.current_, last_element, n);
   }
   void splice_after(iterator position, forward_list&&, iterator first, iterator last) noexcept {
     if (PLEIONE_UNLIKELY(first == last || std::next(first) == last)) { return; }
-    auto first_element = first.current_->next_;
+    hook_type* first_element = first.current_->next_;
     auto last_element = first_element;
-    while (last_element->next_ != last.current_) { last_element = last_element->next_; }
+    auto n = size_type(1);
+    while (last_element->next_ != last.current_) {
+      last_element = last_element->next_;
+      ++n;
+    }
     last_element->next_ = position.current_->next_;
     position.current_->next_ = first_element;
+    linked_after(position.current_, last_element, n);
   }
 
-public:
-  template<bool Prefetch, bool Constant, typename UnaryFunction>
-  friend void for_each(prefetch<Prefetch>, basic_iterator<Constant> first, basic_iterator<Constant> last,
-                       UnaryFunction&& fn) {
-    while (first != last) {
-      if constexpr (Prefetch) { first.prefetch_next(); }
-      fn(*first++);
+  template<typename Compare> void sort(Compare comp) {
+    root_.next_ = detail::merge_sort(
+        static_cast<hook_type*>(root_.next_), [](hook_type* hook) -> auto& { return hook->next_; },
+        [&](hook_type& a, hook_type& b) {
+          return comp(access::template object<T>(a), access::template object<T>(b));
+        });
+    if constexpr (TrackTail) {
+      auto last = &root_;
+      while (last->next_) { last = last->next_; }
+      this->last_ = last;
     }
   }
+  void sort() { sort(std::less<>()); }
+
+  /// \brief Moves the elements into contiguous storage in list order
+  ///
+  /// Each element is relocated to the next slot of `storage` and the hooks are
+  /// rewired, so that a subsequent traversal of the list scans memory
+  /// sequentially. The original objects are destroyed, but their storage is
+  /// not released.
+  ///
+  /// \warning The elements must not be linked into any other container and
+  /// there must be no other references to them.
+  ///
+  /// \param storage uninitialised storage for as many objects as the list has
+  /// \param relocate function taking an element and a destination address,
+  /// relocating the element there and returning a reference to the new object
+  /// \returns pointer past the last relocated element
+  template<typename Relocate> T* relinearize(T* storage, Relocate&& relocate) noexcept {
+    auto prev = &root_;
+    for (hook_type* hook = root_.next_; hook;) {
+      hook_type* next = hook->next_;
+      auto& object = relocate(access::template object<T>(*hook), static_cast<void*>(storage++));
+      auto& new_hook = access::hook(object);
+      prev->next_ = &new_hook;
+      prev = &new_hook;
+      hook = next;
+    }
+    prev->next_ = nullptr;
+    if constexpr (TrackTail) { this->last_ = prev; }
+    return storage;
+  }
+
+  /// \brief Moves the elements into contiguous storage with their move constructor
+  ///
+  /// Like relinearize(storage, relocate), but each element is relocated with
+  /// detail::relocate(). `T` must be nothrow move constructible. The move
+  /// constructor must not move the hook: list_hook and forward_list_hook are
+  /// not movable, so a type holding one needs a user-provided move constructor
+  /// that default-constructs its hook. Otherwise, pass a relocator.
+  ///
+  /// \param storage uninitialised storage for as many objects as the list has
+  /// \returns pointer past the last relocated element
+  T* relinearize(T* storage) noexcept { return relinearize(storage, detail::relocate<T>); }
+
+  /// \brief Repairs the links to elements that have been moved
+  ///
+  /// Rewrites every link to an element of `[first, last)` to point to the
+  /// corresponding element of the range starting at `destination`, in a single
+  /// walk of the list. The old locations are not accessed, so they may have
+  /// already been released, and the ranges may overlap, as when a
+  /// `std::vector` erases an element in the middle.
+  ///
+  /// \param first beginning of the old location of the moved elements
+  /// \param last end of the old location of the moved elements
+  /// \param destination new location of the elements
+  void relink_after_move(T const* first, T const* last, T* destination) noexcept {
+    static_assert(std::is_same_v<typename hook_type::pointer, hook_type*>,
+                  "relink_after_move() requires pointer-based hooks");
+    auto begin = reinterpret_cast<std::uintptr_t>(first);
+    auto size = reinterpret_cast<std::uintptr_t>(last) - begin;
+    auto delta = reinterpret_cast<std::uintptr_t>(destination) - begin;
+    auto relink = [&](hook_type* hook) noexcept {
+      auto address = reinterpret_cast<std::uintptr_t>(hook);
+      return address - begin < size ? reinterpret_cast<hook_type*>(address + delta) : hook;
+    };
+    for (hook_type* hook = &root_; hook->next_; hook = hook->next_) { hook->next_ = relink(hook->next_); }
+    if constexpr (TrackTail) { this->last_ = relink(this->last_); }
+  }
+
+public:
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryFunction>
+  friend void for_each(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                       basic_iterator<Constant> last, UnaryFunction&& fn) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      fn(*it);
+      return false;
+    });
+  }
   template<bool Constant, typename UnaryFunction>
   friend void for_each(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryFunction&& fn) {
     for_each(prefetch<true>{}, first, last, std::forward<UnaryFunction>(fn));
   }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename U,
+           typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                            basic_iterator<Constant> last, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      init = binary_op(std::move(init), unary_op(*it));
+      return false;
+    });
+    return init;
+  }
+  template<bool Constant, typename U, typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(basic_iterator<Constant> first, basic_iterator<Constant> last, U init, BinaryOp&& binary_op,
+                            UnaryOp&& unary_op) {
+    return transform_reduce(prefetch<true>{}, first, last, std::move(init), std::forward<BinaryOp>(binary_op),
+                            std::forward<UnaryOp>(unary_op));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                                          basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return detail::prefetching_find<Depth, Locality, Write, Target>(
+        first, last, [&](basic_iterator<Constant> it) { return bool(pred(*it)); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                          UnaryPredicate&& pred) {
+    return find_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend bool any_of(prefetch<Depth, Locality, Write, Target> pf, basic_iterator<Constant> first,
+                     basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return find_if(pf, first, last, std::forward<UnaryPredicate>(pred)) != last;
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend bool any_of(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return any_of(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend bool all_of(prefetch<Depth, Locality, Write, Target> pf, basic_iterator<Constant> first,
+                     basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return find_if(pf, first, last, [&](auto& object) { return !pred(object); }) == last;
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend bool all_of(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return all_of(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend bool none_of(prefetch<Depth, Locality, Write, Target> pf, basic_iterator<Constant> first,
+                      basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return !any_of(pf, first, last, std::forward<UnaryPredicate>(pred));
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend bool none_of(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return none_of(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend difference_type count_if(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                                  basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    auto n = difference_type(0);
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      n += bool(pred(*it));
+      return false;
+    });
+    return n;
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend difference_type count_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                  UnaryPredicate&& pred) {
+    return count_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
 };
 
 } // namespace intrusive
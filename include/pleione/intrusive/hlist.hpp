@@ -0,0 +1,286 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_HLIST_HPP
+#define PLEIONE_INTRUSIVE_HLIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "core.hpp"
+
+#include "../detail/container_of.hpp"
+#include "../detail/prefetch.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// \brief Hook of intrusive::hlist
+///
+/// Besides the pointer to the next hook the hook holds the address of the
+/// pointer linking to it, either the `next_` of the previous hook or the head
+/// of the list.
+class hlist_hook {
+  hlist_hook* next_;
+  hlist_hook** pprev_;
+
+  template<typename T, auto> friend class hlist;
+
+public:
+  hlist_hook() = default;
+  hlist_hook(hlist_hook const&) = delete;
+  hlist_hook(hlist_hook&&) = delete;
+};
+
+/// \brief Intrusive doubly-linked list with a single pointer head
+///
+/// The list head is just a pointer to the first element, a third of the size
+/// of a list, which makes it suitable for large arrays of buckets. As in the
+/// hlist of the Linux kernel each element has a back-pointer to the pointer
+/// linking to it, so it can be erased in constant time given only a reference
+/// to it, but the list can be traversed only forwards and reaching the last
+/// element takes linear time.
+///
+/// \tparam T type of the elements
+/// \tparam Hook pointer to the hlist_hook member of T
+template<typename T, auto Hook> class hlist {
+  using hook_type = hlist_hook;
+
+  hook_type* first_ = nullptr;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+public:
+  template<bool Constant> class basic_iterator {
+    using hook_type = std::conditional_t<Constant, typename hlist::hook_type const, typename hlist::hook_type>;
+    hook_type* current_ = nullptr;
+
+  private:
+    explicit basic_iterator(hook_type* hook) noexcept : current_(hook) {}
+
+    friend class hlist;
+
+  public:
+    using value_type = std::conditional_t<Constant, T const, T>;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    basic_iterator() = default;
+
+    operator basic_iterator<true>() const noexcept { return basic_iterator<true>(current_); }
+
+    reference operator*() const noexcept { return detail::container_of<value_type, Hook>(*current_); }
+    pointer operator->() const noexcept { return &detail::container_of<value_type, Hook>(*current_); }
+
+    basic_iterator& operator++() noexcept {
+      current_ = current_->next_;
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      auto it = *this;
+      operator++();
+      return it;
+    }
+
+    bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
+    bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
+
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_next() const noexcept {
+      detail::prefetch_element<Locality, Write, Target, T>(detail::offset_of<T, Hook>(), current_->next_);
+    }
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+private:
+  // Links hook in place of the one *link points to, which follows it.
+  static void link(hook_type** link, hook_type& hook) noexcept {
+    auto next = *link;
+    hook.next_ = next;
+    hook.pprev_ = link;
+    if (next) { next->pprev_ = &hook.next_; }
+    *link = &hook;
+  }
+
+public:
+  hlist() = default;
+
+  template<typename ForwardIt> hlist(ForwardIt first, ForwardIt last) noexcept {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    assign(first, last);
+  }
+
+  hlist(hlist const&) = delete;
+  hlist(hlist&& other) noexcept : first_(std::exchange(other.first_, nullptr)) {
+    if (first_) { first_->pprev_ = &first_; }
+  }
+
+  hlist& operator=(hlist const&) = delete;
+  hlist& operator=(hlist&& other) noexcept {
+    if (PLEIONE_UNLIKELY(this == &other)) { return *this; }
+    first_ = std::exchange(other.first_, nullptr);
+    if (first_) { first_->pprev_ = &first_; }
+    return *this;
+  }
+
+  template<typename ForwardIt> void assign(ForwardIt first, ForwardIt last) noexcept {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    clear();
+    auto link = &first_;
+    using std::for_each;
+    for_each(first, last, [&](T& object) {
+      auto& hook = object.*Hook;
+      hook.pprev_ = link;
+      *link = &hook;
+      link = &hook.next_;
+    });
+    *link = nullptr;
+  }
+
+  T& front() noexcept {
+    PLEIONE_ASSERT(!empty());
+    return detail::container_of<T, Hook>(*first_);
+  }
+  T const& front() const noexcept {
+    PLEIONE_ASSERT(!empty());
+    return detail::container_of<T, Hook>(*first_);
+  }
+
+  iterator begin() noexcept { return iterator(first_); }
+  const_iterator begin() const noexcept { return const_iterator(first_); }
+  iterator end() noexcept { return iterator(nullptr); }
+  const_iterator end() const noexcept { return const_iterator(nullptr); }
+
+  /// Returns an iterator to an element of the list.
+  iterator iterator_to(T& object) noexcept { return s_iterator_to(object); }
+  const_iterator iterator_to(T const& object) const noexcept { return s_iterator_to(object); }
+  /// Returns an iterator to an element of any list of this type.
+  static iterator s_iterator_to(T& object) noexcept { return iterator(&(object.*Hook)); }
+  static const_iterator s_iterator_to(T const& object) noexcept { return const_iterator(&(object.*Hook)); }
+
+  bool empty() const noexcept { return !first_; }
+  /// Returns the number of elements, in linear time.
+  size_type size() const noexcept { return std::distance(begin(), end()); }
+
+  void clear() noexcept { first_ = nullptr; }
+
+  /// Inserts an element before position, which must not be end().
+  iterator insert(iterator position, T& object) noexcept {
+    PLEIONE_ASSERT(position != end());
+    auto& hook = object.*Hook;
+    link(position.current_->pprev_, hook);
+    return iterator(&hook);
+  }
+
+  /// Inserts an element after position, which must not be end().
+  iterator insert_after(iterator position, T& object) noexcept {
+    PLEIONE_ASSERT(position != end());
+    auto& hook = object.*Hook;
+    link(&position.current_->next_, hook);
+    return iterator(&hook);
+  }
+
+  /// Erases an element, returns an iterator to the one that followed it.
+  iterator erase(iterator position) noexcept {
+    PLEIONE_ASSERT(position != end());
+    auto& hook = *position.current_;
+    *hook.pprev_ = hook.next_;
+    if (hook.next_) { hook.next_->pprev_ = hook.pprev_; }
+    return iterator(hook.next_);
+  }
+  iterator erase(T& object) noexcept { return erase(iterator_to(object)); }
+
+  void push_front(T& object) noexcept { link(&first_, object.*Hook); }
+
+  void pop_front() noexcept {
+    PLEIONE_ASSERT(!empty());
+    erase(begin());
+  }
+
+public:
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryFunction>
+  friend void for_each(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                       basic_iterator<Constant> last, UnaryFunction&& fn) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      fn(*it);
+      return false;
+    });
+  }
+  template<bool Constant, typename UnaryFunction>
+  friend void for_each(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryFunction&& fn) {
+    for_each(prefetch<true>{}, first, last, std::forward<UnaryFunction>(fn));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename U,
+           typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                            basic_iterator<Constant> last, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      init = binary_op(std::move(init), unary_op(*it));
+      return false;
+    });
+    return init;
+  }
+  template<bool Constant, typename U, typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(basic_iterator<Constant> first, basic_iterator<Constant> last, U init, BinaryOp&& binary_op,
+                            UnaryOp&& unary_op) {
+    return transform_reduce(prefetch<true>{}, first, last, std::move(init), std::forward<BinaryOp>(binary_op),
+                            std::forward<UnaryOp>(unary_op));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                                          basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return detail::prefetching_find<Depth, Locality, Write, Target>(
+        first, last, [&](basic_iterator<Constant> it) { return bool(pred(*it)); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                          UnaryPredicate&& pred) {
+    return find_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+};
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
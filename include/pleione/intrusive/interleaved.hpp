@@ -0,0 +1,124 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_INTERLEAVED_HPP
+#define PLEIONE_INTRUSIVE_INTERLEAVED_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "core.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// \brief Invokes a function on each element of a batch of lists
+///
+/// Walking a short list is a chain of dependent cache misses and there is
+/// little to overlap them with. This walks up to `Width` lists at once,
+/// advancing their cursors in turns, one element at a time. Whenever a cursor
+/// moves to an element it only prefetches it, and the element is visited
+/// after all the other cursors have made their step, so that the misses of
+/// different lists are in flight at the same time. When a list is exhausted
+/// its cursor picks up the next list of the batch.
+///
+/// The elements of each list are visited in order, but the visits to
+/// different lists are interleaved. `fn` may unlink the element it is given,
+/// but no other element of the batch.
+///
+/// Works with any list whose iterators provide `prefetch_next()`, i.e.
+/// intrusive::list and intrusive::forward_list.
+///
+/// \tparam Width maximum number of lists walked at the same time
+/// \param first beginning of the batch of lists
+/// \param last end of the batch of lists
+/// \param fn function invoked with each element
+template<std::size_t Width = 8, typename ListIterator, typename UnaryFunction>
+void for_each_interleaved(ListIterator first, ListIterator last, UnaryFunction&& fn) {
+  static_assert(Width > 0);
+  using list_iterator = decltype(std::begin(*first));
+  struct cursor {
+    list_iterator current;
+    list_iterator end;
+  };
+
+  auto next_list = [&](cursor& c) noexcept {
+    for (; first != last; ++first) {
+      auto begin = std::begin(*first);
+      auto end = std::end(*first);
+      if (begin == end) { continue; }
+      PLEIONE_PREFETCH(std::addressof(*begin));
+      c = cursor{begin, end};
+      ++first;
+      return true;
+    }
+    return false;
+  };
+
+  cursor cursors[Width];
+  auto active = std::size_t(0);
+  while (active < Width && next_list(cursors[active])) { ++active; }
+
+  while (active) {
+    for (auto i = std::size_t(0); i < active;) {
+      auto& c = cursors[i];
+      c.current.prefetch_next();
+      auto& element = *c.current++;
+      auto exhausted = c.current == c.end;
+      if (exhausted && !next_list(c)) { c = cursors[--active]; }
+      // The cursor has been moved out of the way, so fn may unlink element.
+      fn(element);
+      if (!exhausted || i < active) { ++i; }
+    }
+  }
+}
+
+/// \brief Reduces the elements of a batch of lists
+///
+/// The lists are walked as by for_each_interleaved(). Since the visits to
+/// different lists are interleaved `binary_op` has to be associative and
+/// commutative.
+///
+/// \tparam Width maximum number of lists walked at the same time
+/// \param first beginning of the batch of lists
+/// \param last end of the batch of lists
+/// \param init initial value
+/// \param binary_op reduction operation
+/// \param unary_op transformation applied to each element
+/// \returns result of the reduction
+template<std::size_t Width = 8, typename ListIterator, typename U, typename BinaryOp, typename UnaryOp>
+U transform_reduce_interleaved(ListIterator first, ListIterator last, U init, BinaryOp&& binary_op,
+                               UnaryOp&& unary_op) {
+  for_each_interleaved<Width>(first, last, [&](auto& element) {
+    init = binary_op(std::move(init), unary_op(element));
+  });
+  return init;
+}
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_LAZY_CHECKPOINT_INDEX_HPP
+#define PLEIONE_INTRUSIVE_LAZY_CHECKPOINT_INDEX_HPP
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core.hpp"
+#include "list.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// \brief Sparse index of list positions for multi-cursor traversal
+///
+/// The index records an iterator to every `stride`-th element of a list. The
+/// segments between consecutive checkpoints can then be walked by several
+/// interleaved cursors, so that a single thread has as many independent
+/// cache misses in flight as there are cursors, instead of a single chain of
+/// dependent loads.
+///
+/// The index is not maintained incrementally. It is a snapshot of the list
+/// that remembers the generation of the list it was built for. Any
+/// modification of the list makes it stale, and the next traversal rebuilds it
+/// with a full serial walk of the list. The index therefore pays off only for
+/// lists that are traversed many times between modifications. The list has to
+/// be created with the `TrackGeneration` policy.
+///
+/// \tparam List type of the list, an instantiation of intrusive::list
+template<typename List> class lazy_checkpoint_index {
+public:
+  using iterator = typename List::iterator;
+
+private:
+  List* list_;
+  std::size_t stride_;
+  std::size_t generation_ = 0;
+  bool built_ = false;
+  std::vector<iterator> checkpoints_;
+
+public:
+  /// \param list list to index
+  /// \param stride number of elements between consecutive checkpoints
+  explicit lazy_checkpoint_index(List& list, std::size_t stride = 64) : list_(&list), stride_(stride) {
+    PLEIONE_ASSERT(stride > 0);
+  }
+
+  /// Returns whether the index reflects the current state of the list.
+  bool valid() const noexcept { return built_ && generation_ == list_->generation(); }
+
+  /// Rebuilds the index if the list has been modified since it was built.
+  void update() {
+    if (valid()) { return; }
+    checkpoints_.clear();
+    auto n = std::size_t(0);
+    for (auto it = list_->begin(); it != list_->end(); ++it, ++n) {
+      it.prefetch_next();
+      if (n % stride_ == 0) { checkpoints_.emplace_back(it); }
+    }
+    generation_ = list_->generation();
+    built_ = true;
+  }
+
+  std::size_t stride() const noexcept { return stride_; }
+
+  /// Returns the number of segments the list is divided into.
+  std::size_t segments() const noexcept {
+    PLEIONE_ASSERT(valid());
+    return checkpoints_.size();
+  }
+
+  /// Returns the beginning of a segment.
+  iterator segment_begin(std::size_t idx) const noexcept {
+    PLEIONE_ASSERT(valid() && idx < checkpoints_.size());
+    return checkpoints_[idx];
+  }
+
+  /// Returns the end of a segment.
+  iterator segment_end(std::size_t idx) const noexcept {
+    PLEIONE_ASSERT(valid() && idx < checkpoints_.size());
+    return idx + 1 < checkpoints_.size() ? checkpoints_[idx + 1] : list_->end();
+  }
+};
+
+/// \brief Invokes a function on each element using interleaved cursors
+///
+/// Each cursor walks a different segment of the index and the cursors
+/// advance in turns, one element at a time. When a cursor reaches the end of
+/// its segment it moves on to the next unvisited one. The elements are
+/// therefore visited in an unspecified order.
+///
+/// The index is updated first if it is stale.
+///
+/// \tparam Cursors number of interleaved cursors
+/// \param index checkpoint index of the list
+/// \param fn function invoked with each element
+template<std::size_t Cursors = 8, typename List, typename UnaryFunction>
+void for_each(lazy_checkpoint_index<List>& index, UnaryFunction&& fn) {
+  static_assert(Cursors > 0);
+  index.update();
+
+  struct cursor {
+    typename List::iterator current;
+    typename List::iterator end;
+  };
+  cursor cursors[Cursors];
+  auto segments = index.segments();
+  auto next_segment = std::size_t(0);
+  auto active = std::size_t(0);
+  for (; active < Cursors && next_segment < segments; ++active, ++next_segment) {
+    cursors[active] = cursor{index.segment_begin(next_segment), index.segment_end(next_segment)};
+  }
+
+  while (active) {
+    for (auto i = std::size_t(0); i < active;) {
+      auto& c = cursors[i];
+      c.current.prefetch_next();
+      fn(*c.current++);
+      if (c.current != c.end) {
+        ++i;
+      } else if (next_segment < segments) {
+        c = cursor{index.segment_begin(next_segment), index.segment_end(next_segment)};
+        ++next_segment;
+        ++i;
+      } else {
+        c = cursors[--active];
+      }
+    }
+  }
+}
+
+/// \brief Reduces the list using interleaved cursors
+///
+/// Each cursor accumulates its own partial result, the partial results are
+/// combined at the end. Since the order in which elements are visited is
+/// unspecified `binary_op` has to be associative and commutative.
+///
+/// The index is updated first if it is stale.
+///
+/// \tparam Cursors number of interleaved cursors
+/// \param index checkpoint index of the list
+/// \param init initial value
+/// \param binary_op reduction operation
+/// \param unary_op transformation applied to each element
+/// \returns result of the reduction
+template<std::size_t Cursors = 8, typename List, typename U, typename BinaryOp, typename UnaryOp>
+U transform_reduce(lazy_checkpoint_index<List>& index, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+  static_assert(Cursors > 0);
+  index.update();
+
+  struct cursor {
+    typename List::iterator current;
+    typename List::iterator end;
+  };
+  cursor cursors[Cursors];
+  std::optional<U> values[Cursors];
+  auto segments = index.segments();
+  auto next_segment = std::size_t(0);
+  auto active = std::size_t(0);
+  for (; active < Cursors && next_segment < segments; ++active, ++next_segment) {
+    auto first = index.segment_begin(next_segment);
+    values[active].emplace(unary_op(*first++));
+    cursors[active] = cursor{first, index.segment_end(next_segment)};
+  }
+
+  auto used = active;
+  while (active) {
+    for (auto i = std::size_t(0); i < active;) {
+      auto& c = cursors[i];
+      if (c.current != c.end) {
+        c.current.prefetch_next();
+        values[i] = binary_op(std::move(*values[i]), unary_op(*c.current++));
+        ++i;
+      } else if (next_segment < segments) {
+        c = cursor{index.segment_begin(next_segment), index.segment_end(next_segment)};
+        ++next_segment;
+      } else {
+        --active;
+        std::swap(c, cursors[active]);
+        std::swap(values[i], values[active]);
+      }
+    }
+  }
+
+  for (auto i = std::size_t(0); i < used; ++i) { init = binary_op(std::move(init), std::move(*values[i])); }
+  return init;
+}
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
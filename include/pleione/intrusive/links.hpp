@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_LINKS_HPP
+#define PLEIONE_INTRUSIVE_LINKS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "core.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+/// \brief Pointer to a hook stored as a 32-bit offset from the base of an arena
+///
+/// Offset 0 represents the null pointer, so no hook may be located at the
+/// base address itself.
+///
+/// \tparam Hook type of the hook
+/// \tparam Arena type providing a static `base()` function
+template<typename Hook, typename Arena> class arena_pointer {
+  std::uint32_t offset_;
+
+private:
+  static std::uintptr_t base() noexcept { return reinterpret_cast<std::uintptr_t>(Arena::base()); }
+
+  static std::uint32_t encode(Hook* hook) noexcept {
+    if (!hook) { return 0; }
+    auto offset = reinterpret_cast<std::uintptr_t>(hook) - base();
+    PLEIONE_ASSERT(offset > 0 && offset <= std::numeric_limits<std::uint32_t>::max());
+    return std::uint32_t(offset);
+  }
+
+public:
+  arena_pointer() = default;
+  arena_pointer(std::nullptr_t) noexcept : offset_(0) {}
+  arena_pointer(Hook* hook) noexcept : offset_(encode(hook)) {}
+
+  arena_pointer& operator=(std::nullptr_t) noexcept {
+    offset_ = 0;
+    return *this;
+  }
+  arena_pointer& operator=(Hook* hook) noexcept {
+    offset_ = encode(hook);
+    return *this;
+  }
+
+  operator Hook*() const noexcept { return offset_ ? reinterpret_cast<Hook*>(base() + offset_) : nullptr; }
+  Hook* operator->() const noexcept { return *this; }
+  Hook& operator*() const noexcept { return *static_cast<Hook*>(*this); }
+};
+
+/// \brief Pointer to a hook stored as an offset from the pointer itself
+///
+/// Like `boost::interprocess::offset_ptr` the pointer stays valid as long as
+/// it and its target are moved together, e.g. when both are in a memory
+/// mapping placed at different addresses in different processes. Copying
+/// re-encodes the offset relative to the destination. Offset 1 represents the
+/// null pointer, offset 0 is a pointer to itself.
+///
+/// \tparam Hook type of the hook
+template<typename Hook> class relative_pointer {
+  std::ptrdiff_t offset_;
+
+private:
+  static constexpr std::ptrdiff_t null = 1;
+
+  std::ptrdiff_t encode(Hook* hook) const noexcept {
+    if (!hook) { return null; }
+    return std::ptrdiff_t(reinterpret_cast<std::uintptr_t>(hook) - reinterpret_cast<std::uintptr_t>(this));
+  }
+
+public:
+  relative_pointer() = default;
+  relative_pointer(std::nullptr_t) noexcept : offset_(null) {}
+  relative_pointer(Hook* hook) noexcept : offset_(encode(hook)) {}
+  relative_pointer(relative_pointer const& other) noexcept : offset_(encode(other)) {}
+
+  relative_pointer& operator=(std::nullptr_t) noexcept {
+    offset_ = null;
+    return *this;
+  }
+  relative_pointer& operator=(Hook* hook) noexcept {
+    offset_ = encode(hook);
+    return *this;
+  }
+  relative_pointer& operator=(relative_pointer const& other) noexcept {
+    offset_ = encode(other);
+    return *this;
+  }
+
+  operator Hook*() const noexcept {
+    if (offset_ == null) { return nullptr; }
+    return reinterpret_cast<Hook*>(reinterpret_cast<std::uintptr_t>(this) + std::uintptr_t(offset_));
+  }
+  Hook* operator->() const noexcept { return *this; }
+  Hook& operator*() const noexcept { return *static_cast<Hook*>(*this); }
+};
+
+} // namespace detail
+
+namespace intrusive {
+
+/// \brief Link representation of hooks storing plain pointers
+///
+/// This is the default, the hooks are two (list_hook) or one
+/// (forward_list_hook) pointers wide and can be located anywhere in memory.
+struct pointer_links {
+  template<typename Hook> using pointer = Hook*;
+};
+
+/// \brief Link representation of hooks storing 32-bit offsets from an arena
+///
+/// The hooks are half the size of pointer-based ones, which improves the
+/// cache density of small elements. All linked hooks, including the ones in
+/// the list headers, have to be located in the 4 GiB following
+/// `Arena::base()`, excluding the base address itself. The base must not
+/// change while any of them is linked, or a list header constructed.
+///
+/// \tparam Arena type with a static `base()` function returning a pointer to
+/// the beginning of the arena
+template<typename Arena> struct arena_links {
+  template<typename Hook> using pointer = detail::arena_pointer<Hook, Arena>;
+};
+
+/// \brief Link representation of hooks storing offsets from the links themselves
+///
+/// The links do not depend on the address at which the hooks are located, so
+/// a list header and its elements placed in a shared memory mapping can be
+/// traversed and modified by processes that map it at different addresses.
+/// The header has to be in the same mapping as the elements.
+struct relative_links {
+  template<typename Hook> using pointer = detail::relative_pointer<Hook>;
+};
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
@@ -24,33 +24,181 @@
 #define PLEIONE_INTRUSIVE_LIST_HPP
 
 #include <algorithm>
+#include <functional>
+#include <utility>
 
 #include "core.hpp"
+#include "links.hpp"
 
 #include "../detail/container_of.hpp"
+#include "../detail/hook_access.hpp"
+#include "../detail/merge_sort.hpp"
+#include "../detail/prefetch.hpp"
+#include "../detail/relocate.hpp"
 
 PLEIONE_NAMESPACE_BEGIN
 
 namespace intrusive {
 
-class list_hook {
-  list_hook* next_;
-  list_hook* prev_;
+/// \brief Hook of intrusive::list
+///
+/// \tparam Links representation of the links: pointer_links, arena_links or
+/// relative_links
+template<typename Links = pointer_links> class basic_list_hook {
+public:
+  /// Representation of a link to another hook.
+  using pointer = typename Links::template pointer<basic_list_hook>;
+
+private:
+  pointer next_;
+  pointer prev_;
 
 private:
-  list_hook(list_hook* prev, list_hook* next) noexcept : next_(next), prev_(prev) {}
+  basic_list_hook(basic_list_hook* prev, basic_list_hook* next) noexcept : next_(next), prev_(prev) {}
+
+  template<typename T, auto, bool, bool> friend class list;
+  friend class relocatable_list_hook;
+  friend class auto_unlink_list_hook;
+
+public:
+  basic_list_hook() = default;
+  basic_list_hook(basic_list_hook const&) = delete;
+  basic_list_hook(basic_list_hook&&) = delete;
+};
+
+using list_hook = basic_list_hook<>;
+
+/// Hook storing 32-bit offsets from the base of `Arena`, see arena_links.
+template<typename Arena> using compact_list_hook = basic_list_hook<arena_links<Arena>>;
+/// Hook storing offsets from itself, usable in shared memory, see relative_links.
+using offset_list_hook = basic_list_hook<relative_links>;
+
+/// \brief Base class hook of intrusive::list
+///
+/// An element may inherit several base hooks with different tags and be linked
+/// through each of them, e.g. `struct conn : list_base_hook<by_lru>,
+/// list_base_hook<by_owner>` into `list<conn, base_hook<by_lru>>`.
+///
+/// \tparam Tag type distinguishing the base hooks of an element
+/// \tparam Links representation of the links
+template<typename Tag, typename Links = pointer_links> class list_base_hook : public basic_list_hook<Links> {
+public:
+  using hook_type = basic_list_hook<Links>;
+};
+
+/// \brief Hook of intrusive::list that can be moved with its element
+///
+/// Moving a linked hook puts the new one in place of the original in its list
+/// and leaves the original unlinked, so elements may be kept in a growing
+/// `std::vector`. Iterators to a moved element are invalidated. Only unlinked
+/// hooks may be assigned to.
+///
+/// To tell whether a hook is linked, unlinked hooks have null links. The list
+/// resets the hooks of the elements it erases, or still has when it is
+/// destroyed, so erasing a range, clear() and the destructor take linear time.
+class relocatable_list_hook : public list_hook {
+public:
+  using hook_type = list_hook;
+
+  static constexpr bool safe_link = true;
+
+private:
+  void take(relocatable_list_hook& other) noexcept {
+    if (!other.next_) { return; }
+    next_ = std::exchange(other.next_, nullptr);
+    prev_ = std::exchange(other.prev_, nullptr);
+    next_->prev_ = this;
+    prev_->next_ = this;
+  }
+
+public:
+  relocatable_list_hook() noexcept : list_hook(nullptr, nullptr) {}
+  relocatable_list_hook(relocatable_list_hook&& other) noexcept : list_hook(nullptr, nullptr) { take(other); }
 
-  template<typename T, list_hook T::*> friend class list;
+  relocatable_list_hook& operator=(relocatable_list_hook&& other) noexcept {
+    PLEIONE_ASSERT(!is_linked() || this == &other);
+    take(other);
+    return *this;
+  }
+
+  bool is_linked() const noexcept { return next_ != nullptr; }
+};
 
+/// \brief Hook of intrusive::list that unlinks itself when destroyed
+///
+/// An element can leave its list, by unlink() or by being destroyed, in
+/// constant time and without access to the list. The list cannot know about
+/// it, so it must track neither its size nor its modifications, i.e. have
+/// `ConstantTimeSize` and `TrackGeneration` unset. As with
+/// relocatable_list_hook unlinked hooks have null links.
+class auto_unlink_list_hook : public list_hook {
 public:
-  list_hook() = default;
-  list_hook(list_hook const&) = delete;
-  list_hook(list_hook&&) = delete;
+  using hook_type = list_hook;
+
+  static constexpr bool safe_link = true;
+  static constexpr bool auto_unlink = true;
+
+public:
+  auto_unlink_list_hook() noexcept : list_hook(nullptr, nullptr) {}
+  ~auto_unlink_list_hook() { unlink(); }
+
+  bool is_linked() const noexcept { return next_ != nullptr; }
+
+  /// Removes the element from its list, if it is linked.
+  void unlink() noexcept {
+    if (!next_) { return; }
+    next_->prev_ = prev_;
+    prev_->next_ = next_;
+    next_ = nullptr;
+    prev_ = nullptr;
+  }
 };
 
-template<typename T, list_hook T::*Hook> class list {
-  list_hook root_ = {&root_, &root_};
+} // namespace intrusive
+
+namespace detail {
+
+template<bool ConstantTimeSize> struct list_size {};
+
+template<> struct list_size<true> {
   std::size_t size_ = 0;
+};
+
+template<bool TrackGeneration> struct list_generation {};
+
+template<> struct list_generation<true> {
+  std::size_t generation_ = 0;
+};
+
+} // namespace detail
+
+namespace intrusive {
+
+/// \brief Intrusive doubly-linked list
+///
+/// By default the list keeps track of the number of its elements. If
+/// `ConstantTimeSize` is not set the list head is just two pointers, size()
+/// walks the list, and splicing or erasing a range no longer needs to count
+/// its elements, so every splice and erase is constant time.
+///
+/// If `TrackGeneration` is set the list counts its modifications, which lets
+/// auxiliary structures such as lazy_checkpoint_index detect that they are
+/// stale.
+///
+/// \tparam T type of the elements
+/// \tparam Hook pointer to the basic_list_hook member of T, or base_hook<Tag>
+/// if T inherits from list_base_hook<Tag>
+/// \tparam ConstantTimeSize whether to track the number of elements
+/// \tparam TrackGeneration whether to count modifications of the list
+template<typename T, auto Hook, bool ConstantTimeSize = true, bool TrackGeneration = false>
+class list : detail::list_size<ConstantTimeSize>, detail::list_generation<TrackGeneration> {
+  using access = detail::hook_access<T, Hook, list_base_hook>;
+  using hook_type = typename access::hook_type;
+
+  static_assert(!access::auto_unlink || (!ConstantTimeSize && !TrackGeneration),
+                "auto-unlink hooks require a list that tracks neither its size nor its modifications");
+
+  hook_type root_ = {&root_, &root_};
 
 public:
   using value_type = T;
@@ -63,7 +211,7 @@ public:
 
 public:
   template<bool Constant> class basic_iterator {
-    using hook_type = std::conditional_t<Constant, list_hook const, list_hook>;
+    using hook_type = std::conditional_t<Constant, typename list::hook_type const, typename list::hook_type>;
     hook_type* current_ = nullptr;
 
   private:
@@ -82,8 +230,8 @@ public:
 
     operator basic_iterator<true>() const noexcept { return basic_iterator<true>(current_); }
 
-    reference operator*() const noexcept { return detail::container_of<value_type, hook_type>(Hook, *current_); }
-    pointer operator->() const noexcept { return &detail::container_of<value_type, hook_type>(Hook, *current_); }
+    reference operator*() const noexcept { return access::template object<value_type>(*current_); }
+    pointer operator->() const noexcept { return &access::template object<value_type>(*current_); }
 
     basic_iterator& operator++() noexcept {
       current_ = current_->next_;
@@ -108,8 +256,16 @@ public:
     bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
     bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
 
-    void prefetch_next() const noexcept { PLEIONE_PREFETCH(current_->next_); }
-    void prefetch_previous() const noexcept { PLEIONE_PREFETCH(current_->prev_); }
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_next() const noexcept {
+      detail::prefetch_element<Locality, Write, Target, T>(access::offset(),
+                                                           static_cast<hook_type const*>(current_->next_));
+    }
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_previous() const noexcept {
+      detail::prefetch_element<Locality, Write, Target, T>(access::offset(),
+                                                           static_cast<hook_type const*>(current_->prev_));
+    }
   };
 
 public:
@@ -118,76 +274,127 @@ public:
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-public:
-  list() = default;
+private:
+  void add_size(size_type n) noexcept {
+    if constexpr (ConstantTimeSize) { this->size_ += n; }
+  }
+  void subtract_size(size_type n) noexcept {
+    if constexpr (ConstantTimeSize) { this->size_ -= n; }
+  }
+  void set_size(size_type n) noexcept {
+    if constexpr (ConstantTimeSize) { this->size_ = n; }
+  }
 
-  template<typename ForwardIt> list(ForwardIt first, ForwardIt last) noexcept {
-    static_assert(
-        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
-    assign(first, last);
+  void modified() noexcept {
+    if constexpr (TrackGeneration) { ++this->generation_; }
   }
 
-  list(list const&) = delete;
-  list(list&& other) noexcept : size_(other.size_) {
-    if (PLEIONE_UNLIKELY(!other.empty())) {
-      root_.next_ = other.root_.next_;
-      root_.prev_ = other.root_.prev_;
-      root_.next_->prev_ = &root_;
-      root_.prev_->next_ = &root_;
+  size_type tracked_size() const noexcept {
+    if constexpr (ConstantTimeSize) {
+      return this->size_;
     } else {
-      root_.next_ = &root_;
-      root_.prev_ = &root_;
+      return 0;
     }
   }
 
-  list& operator=(list const&) = delete;
-  list& operator=(list&& other) noexcept {
-    size_ = other.size_;
+  // Resets the hooks in [first, last) of erased elements, if they need to know
+  // whether they are linked.
+  static void unlinked(hook_type* first, hook_type* last) noexcept {
+    if constexpr (access::safe_link) {
+      while (first != last) {
+        hook_type* next = first->next_;
+        first->next_ = nullptr;
+        first->prev_ = nullptr;
+        first = next;
+      }
+    }
+  }
+
+  // Moves the elements of other, which is left empty.
+  void take(list& other) noexcept {
+    other.modified();
+    set_size(other.tracked_size());
     if (PLEIONE_UNLIKELY(!other.empty())) {
       root_.next_ = other.root_.next_;
       root_.prev_ = other.root_.prev_;
       root_.next_->prev_ = &root_;
       root_.prev_->next_ = &root_;
+      other.root_.next_ = &other.root_;
+      other.root_.prev_ = &other.root_;
+      other.set_size(0);
     } else {
       root_.next_ = &root_;
       root_.prev_ = &root_;
     }
+  }
+
+  // Number of elements in [first, last), only computed if the size is tracked.
+  static size_type tracked_distance(iterator first, iterator last) noexcept {
+    if constexpr (ConstantTimeSize) {
+      return std::distance(first, last);
+    } else {
+      return 0;
+    }
+  }
+
+public:
+  list() = default;
+
+  template<typename ForwardIt> list(ForwardIt first, ForwardIt last) noexcept {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    assign(first, last);
+  }
+
+  list(list const&) = delete;
+  list(list&& other) noexcept { take(other); }
+  ~list() { unlinked(root_.next_, &root_); }
+
+  list& operator=(list const&) = delete;
+  list& operator=(list&& other) noexcept {
+    if (PLEIONE_UNLIKELY(this == &other)) { return *this; }
+    modified();
+    unlinked(root_.next_, &root_);
+    take(other);
     return *this;
   }
 
   template<typename ForwardIt> void assign(ForwardIt first, ForwardIt last) noexcept {
+    modified();
+    unlinked(root_.next_, &root_);
     static_assert(
         std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
-    size_ = 0;
+    auto n = size_type(0);
     auto prev = &root_;
     using std::for_each;
     for_each(first, last, [&](T& object) {
-      auto& hook = object.*Hook;
+      auto& hook = access::hook(object);
       hook.prev_ = prev;
       prev->next_ = &hook;
       prev = &hook;
-      size_++;
+      ++n;
     });
+    set_size(n);
     root_.prev_ = prev;
     prev->next_ = &root_;
   }
 
   T& front() noexcept {
-    PLEIONE_ASSERT(size_);
-    return detail::container_of<T, list_hook>(Hook, *root_.next_);
+    PLEIONE_ASSERT(!empty());
+    return access::template object<T>(*root_.next_);
   }
   T const& front() const noexcept {
-    PLEIONE_ASSERT(size_);
-    return detail::container_of<T, list_hook>(Hook, *root_.next_);
+    PLEIONE_ASSERT(!empty());
+    return access::template object<T>(*root_.next_);
   }
 
   T& back() noexcept {
-    PLEIONE_ASSERT(size_);
-    return detail::container_of<T, list_hook>(Hook, *root_.prev_);
+    PLEIONE_ASSERT(!empty());
+    return access::template object<T>(*root_.prev_);
   }
   T const& back() const noexcept {
-    PLEIONE_ASSERT(size_);
-    return detail::container_of<T, list_hook>(Hook, *root_.prev_);
+    PLEIONE_ASSERT(!empty());
+    return access::template object<T>(*root_.prev_);
   }
 
   iterator begin() noexcept { return iterator(root_.next_); }
@@ -195,186 +402,281 @@ public:
   iterator end() noexcept { return iterator(&root_); }
   const_iterator end() const noexcept { return const_iterator(&root_); }
 
+  /// Returns an iterator to an element of the list.
+  iterator iterator_to(T& object) noexcept { return s_iterator_to(object); }
+  const_iterator iterator_to(T const& object) const noexcept { return s_iterator_to(object); }
+  /// Returns an iterator to an element of any list of this type.
+  static iterator s_iterator_to(T& object) noexcept { return iterator(&access::hook(object)); }
+  static const_iterator s_iterator_to(T const& object) noexcept { return const_iterator(&access::hook(object)); }
+
   reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
   const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
   reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
   const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
 
-  bool empty() const noexcept { return size_ == 0; }
+  bool empty() const noexcept { return root_.next_ == &root_; }
+
+  /// Returns the number of modifications of the list so far.
+  std::size_t generation() const noexcept {
+    static_assert(TrackGeneration, "generation() requires a list that tracks its modifications");
+    return this->generation_;
+  }
 
-  size_type size() const noexcept { return size_; }
+  /// Returns the number of elements, in linear time if `ConstantTimeSize` is not set.
+  size_type size() const noexcept {
+    if constexpr (ConstantTimeSize) {
+      return this->size_;
+    } else {
+      return std::distance(begin(), end());
+    }
+  }
 
   void clear() noexcept {
+    modified();
+    unlinked(root_.next_, &root_);
     root_.next_ = &root_;
     root_.prev_ = &root_;
-    size_ = 0;
+    set_size(0);
   }
 
   iterator insert(iterator position, T& object) noexcept {
-    auto& hook = object.*Hook;
+    modified();
+    auto& hook = access::hook(object);
     hook.next_ = position.current_;
     hook.prev_ = position.current_->prev_;
     position.current_->prev_->next_ = &hook;
     position.current_->prev_ = &hook;
-    ++size_;
+    add_size(1);
     return iterator(&hook);
   }
 
   template<typename ForwardIt> iterator insert(iterator position, ForwardIt first, ForwardIt last) noexcept {
+    modified();
     static_assert(
         std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
     if (PLEIONE_UNLIKELY(first == last)) { return position; }
     auto after = position.current_;
-    auto prev = after->prev_;
-    auto ret = after->prev_;
+    hook_type* prev = after->prev_;
+    hook_type* ret = after->prev_;
+    auto n = size_type(0);
     using std::for_each;
     for_each(first, last, [&](T& object) {
-      auto& hook = object.*Hook;
+      auto& hook = access::hook(object);
       hook.prev_ = prev;
       prev->next_ = &hook;
       prev = &hook;
-      ++size_;
+      ++n;
     });
+    add_size(n);
     after->prev_ = prev;
     prev->next_ = after;
     return iterator(ret->next_);
   }
 
   iterator erase(iterator position) noexcept {
+    modified();
     auto& hook = *position.current_;
-    hook.prev_->next_ = hook.next_;
-    hook.next_->prev_ = hook.prev_;
-    --size_;
-    return iterator(hook.next_);
+    hook_type* next = hook.next_;
+    hook.prev_->next_ = next;
+    next->prev_ = hook.prev_;
+    subtract_size(1);
+    unlinked(&hook, next);
+    return iterator(next);
   }
 
   iterator erase(iterator first, iterator last) noexcept {
-    first.current_->prev_->next_ = last.current_;
-    last.current_->prev_ = first.current_->prev_;
-    size_ -= std::distance(first, last);
+    modified();
+    subtract_size(tracked_distance(first, last));
+    hook_type* before = first.current_->prev_;
+    unlinked(first.current_, last.current_);
+    before->next_ = last.current_;
+    last.current_->prev_ = before;
     return iterator(last.current_);
   }
+  iterator erase(T& object) noexcept { return erase(iterator_to(object)); }
 
   void push_front(T& object) noexcept {
-    auto& hook = object.*Hook;
+    modified();
+    auto& hook = access::hook(object);
     hook.prev_ = &root_;
     root_.next_->prev_ = &hook;
     hook.next_ = root_.next_;
     root_.next_ = &hook;
-    size_++;
+    add_size(1);
   }
 
   void push_back(T& object) noexcept {
-    auto& hook = object.*Hook;
+    modified();
+    auto& hook = access::hook(object);
     hook.next_ = &root_;
     root_.prev_->next_ = &hook;
     hook.prev_ = root_.prev_;
     root_.prev_ = &hook;
-    size_++;
+    add_size(1);
   }
 
   void pop_front() noexcept {
-    PLEIONE_ASSERT(size_);
-    root_.next_ = root_.next_->next_;
+    modified();
+    PLEIONE_ASSERT(!empty());
+    hook_type* hook = root_.next_;
+    root_.next_ = hook->next_;
     root_.next_->prev_ = &root_;
-    size_--;
+    subtract_size(1);
+    unlinked(hook, root_.next_);
   }
 
   void pop_back() noexcept {
-    PLEIONE_ASSERT(size_);
-    root_.prev_ = root_.prev_->prev_;
+    modified();
+    PLEIONE_ASSERT(!empty());
+    hook_type* hook = root_.prev_;
+    root_.prev_ = hook->prev_;
     root_.prev_->next_ = &root_;
-    size_--;
+    subtract_size(1);
+    unlinked(hook, &root_);
   }
 
   void splice(iterator position, list& other) noexcept {
+    modified();
+    other.modified();
     if (PLEIONE_UNLIKELY(other.empty())) { return; }
     auto after = position.current_;
     other.root_.prev_->next_ = after;
     after->prev_->next_ = other.root_.next_;
     other.root_.next_->prev_ = after->prev_;
     after->prev_ = other.root_.prev_;
-    size_ += other.size_;
+    add_size(other.tracked_size());
     other.root_.next_ = &other.root_;
     other.root_.prev_ = &other.root_;
-    other.size_ = 0;
-  }
-  void splice(iterator position, list&& other) noexcept {
-    if (PLEIONE_UNLIKELY(other.empty())) { return; }
-    auto after = position.current_;
-    other.root_.prev_->next_ = after;
-    after->prev_->next_ = other.root_.next_;
-    other.root_.next_->prev_ = after->prev_;
-    after->prev_ = other.root_.prev_;
-    size_ += other.size_;
+    other.set_size(0);
   }
+  void splice(iterator position, list&& other) noexcept { splice(position, other); }
 
   void splice(iterator position, list& other, iterator element) noexcept {
     auto& object = *element;
     other.erase(element);
     insert(position, object);
   }
-  void splice(iterator position, list&&, iterator element) noexcept { insert(position, *element); }
+  void splice(iterator position, list&& other, iterator element) noexcept { splice(position, other, element); }
 
   void splice(iterator position, list& other, iterator first, iterator last) noexcept {
+    modified();
+    other.modified();
     if (PLEIONE_UNLIKELY(first == last)) { return; }
-    auto n = std::distance(first, last);
-    auto other_before = first.current_->prev_;
+    auto n = tracked_distance(first, last);
+    hook_type* other_before = first.current_->prev_;
     auto other_after = last.current_;
-    auto last_prev = other_after->prev_;
+    hook_type* last_prev = other_after->prev_;
     other_before->next_ = other_after;
     other_after->prev_ = other_before;
-    other.size_ -= n;
+    other.subtract_size(n);
     auto after = position.current_;
-    auto before = after->prev_;
+    hook_type* before = after->prev_;
     before->next_ = first.current_;
     first.current_->prev_ = before;
     after->prev_ = last_prev;
     last_prev->next_ = after;
-    size_ += n;
+    add_size(n);
   }
-  void splice(iterator position, list&&, iterator first, iterator last) noexcept {
-    if (PLEIONE_UNLIKELY(first == last)) { return; }
-    auto n = std::distance(first, last);
-    auto after = position.current_;
-    auto before = after->prev_;
-    before->next_ = first.current_;
-    first.current_->prev_ = before;
-    after->prev_ = last.current_->prev_;
-    last.current_->prev_->next_ = after;
-    size_ += n;
+  void splice(iterator position, list&& other, iterator first, iterator last) noexcept {
+    splice(position, other, first, last);
   }
 
-public:
-  template<bool Prefetch, bool Constant, typename UnaryFunction>
-  friend void for_each(prefetch<Prefetch>, basic_iterator<Constant> first, basic_iterator<Constant> last,
-                       UnaryFunction&& fn) {
-    while (first != last) {
-      if constexpr (Prefetch) { first.prefetch_next(); }
-      fn(*first++);
+  template<typename Compare> void sort(Compare comp) {
+    modified();
+    if (root_.next_ == root_.prev_) { return; }
+    root_.prev_->next_ = nullptr;
+    auto head = detail::merge_sort(
+        static_cast<hook_type*>(root_.next_), [](hook_type* hook) -> auto& { return hook->next_; },
+        [&](hook_type& a, hook_type& b) {
+          return comp(access::template object<T>(a), access::template object<T>(b));
+        });
+    auto prev = &root_;
+    for (hook_type* hook = head; hook; hook = hook->next_) {
+      hook->prev_ = prev;
+      prev = hook;
     }
+    root_.next_ = head;
+    root_.prev_ = prev;
+    prev->next_ = &root_;
+  }
+  void sort() { sort(std::less<>()); }
+
+  /// \brief Moves the elements into contiguous storage in list order
+  ///
+  /// Each element is relocated to the next slot of `storage` and the hooks are
+  /// rewired, so that a subsequent traversal of the list scans memory
+  /// sequentially. The original objects are destroyed, but their storage is
+  /// not released.
+  ///
+  /// \warning The elements must not be linked into any other container and
+  /// there must be no other references to them.
+  ///
+  /// \param storage uninitialised storage for as many objects as the list has
+  /// \param relocate function taking an element and a destination address,
+  /// relocating the element there and returning a reference to the new object
+  /// \returns pointer past the last relocated element
+  template<typename Relocate> T* relinearize(T* storage, Relocate&& relocate) noexcept {
+    modified();
+    auto prev = &root_;
+    for (hook_type* hook = root_.next_; hook != &root_;) {
+      hook_type* next = hook->next_;
+      auto& object = relocate(access::template object<T>(*hook), static_cast<void*>(storage++));
+      auto& new_hook = access::hook(object);
+      new_hook.prev_ = prev;
+      prev->next_ = &new_hook;
+      prev = &new_hook;
+      hook = next;
+    }
+    root_.prev_ = prev;
+    prev->next_ = &root_;
+    return storage;
+  }
+
+  /// \brief Moves the elements into contiguous storage with their move constructor
+  ///
+  /// Like relinearize(storage, relocate), but each element is relocated with
+  /// detail::relocate(). `T` must be nothrow move constructible. The move
+  /// constructor must not move the hook: list_hook and forward_list_hook are
+  /// not movable, so a type holding one needs a user-provided move constructor
+  /// that default-constructs its hook. Otherwise, pass a relocator.
+  ///
+  /// \param storage uninitialised storage for as many objects as the list has
+  /// \returns pointer past the last relocated element
+  T* relinearize(T* storage) noexcept { return relinearize(storage, detail::relocate<T>); }
+
+public:
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryFunction>
+  friend void for_each(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                       basic_iterator<Constant> last, UnaryFunction&& fn) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      fn(*it);
+      return false;
+    });
   }
   template<bool Constant, typename UnaryFunction>
   friend void for_each(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryFunction&& fn) {
     for_each(prefetch<true>{}, first, last, std::forward<UnaryFunction>(fn));
   }
 
-  template<bool Prefetch, bool Constant, typename U, typename BinaryOp, typename UnaryOp>
-  friend U transform_reduce(prefetch<Prefetch>, basic_iterator<Constant> first, basic_iterator<Constant> last, U init,
-                            BinaryOp&& binary_op, UnaryOp&& unary_op) {
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename U,
+           typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                            basic_iterator<Constant> last, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+    // Walking the list from both ends at once keeps two independent chains of
+    // loads in flight, which beats any lookahead along a single one.
     if (first == last) { return init; }
 
     auto front = std::move(init);
     auto back = unary_op(*--last);
 
     while (first != last) {
-      if constexpr (Prefetch) { first.prefetch_next(); }
+      if constexpr (Depth > 0) { first.template prefetch_next<Locality, Write, Target>(); }
       front = binary_op(std::move(front), unary_op(*first++));
 
       if (first == last) { break; }
 
       --last;
-      if constexpr (Prefetch) { last.prefetch_previous(); }
+      if constexpr (Depth > 0) { last.template prefetch_previous<Locality, Write, Target>(); }
       back = binary_op(std::move(back), unary_op(*last));
     }
     return binary_op(front, back);
@@ -385,6 +687,71 @@ public:
     return transform_reduce(prefetch<true>{}, first, last, std::move(init), std::forward<BinaryOp>(binary_op),
                             std::forward<UnaryOp>(unary_op));
   }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                                          basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return detail::prefetching_find<Depth, Locality, Write, Target>(
+        first, last, [&](basic_iterator<Constant> it) { return bool(pred(*it)); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                          UnaryPredicate&& pred) {
+    return find_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  // Like transform_reduce, the range is searched from both ends at once.
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend bool any_of(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                     basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    while (first != last) {
+      if constexpr (Depth > 0) { first.template prefetch_next<Locality, Write, Target>(); }
+      if (pred(*first++)) { return true; }
+
+      if (first == last) { break; }
+
+      --last;
+      if constexpr (Depth > 0) { last.template prefetch_previous<Locality, Write, Target>(); }
+      if (pred(*last)) { return true; }
+    }
+    return false;
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend bool any_of(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return any_of(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend bool all_of(prefetch<Depth, Locality, Write, Target> pf, basic_iterator<Constant> first,
+                     basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return !any_of(pf, first, last, [&](auto& object) { return !pred(object); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend bool all_of(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return all_of(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend bool none_of(prefetch<Depth, Locality, Write, Target> pf, basic_iterator<Constant> first,
+                      basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return !any_of(pf, first, last, std::forward<UnaryPredicate>(pred));
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend bool none_of(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return none_of(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend difference_type count_if(prefetch<Depth, Locality, Write, Target> pf, basic_iterator<Constant> first,
+                                  basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return transform_reduce(pf, first, last, difference_type(0), std::plus<>{},
+                            [&](auto& object) { return difference_type(bool(pred(object))); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend difference_type count_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                  UnaryPredicate&& pred) {
+    return count_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
 };
 
 } // namespace intrusive
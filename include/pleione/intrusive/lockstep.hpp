@@ -0,0 +1,259 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_LOCKSTEP_HPP
+#define PLEIONE_INTRUSIVE_LOCKSTEP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+// Gathers are slow on some microarchitectures (and with some microcode
+// mitigations), so the vectorised implementation has to be requested
+// explicitly, in addition to enabling the instruction set. The gathers load
+// 64-bit pointers, so they are available only on x86-64.
+#if PLEIONE_LOCKSTEP_GATHER && (defined(__x86_64__) || defined(_M_X64))
+#if defined(__AVX512F__)
+#define PLEIONE_LOCKSTEP_AVX512 1
+#elif defined(__AVX2__)
+#define PLEIONE_LOCKSTEP_AVX2 1
+#endif
+#endif
+
+#if PLEIONE_LOCKSTEP_AVX512 || PLEIONE_LOCKSTEP_AVX2
+#include <immintrin.h>
+#endif
+
+#include "core.hpp"
+#include "forward_list.hpp"
+
+#include "../detail/container_of.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// Number of lists find_lockstep() walks at the same time. It is the width of
+/// the vector registers holding the cursors: 8 with AVX-512, 4 with AVX2, and
+/// 8 for the scalar implementation.
+#if PLEIONE_LOCKSTEP_AVX512
+inline constexpr std::size_t lockstep_width = 8;
+#elif PLEIONE_LOCKSTEP_AVX2
+inline constexpr std::size_t lockstep_width = 4;
+#else
+inline constexpr std::size_t lockstep_width = 8;
+#endif
+
+} // namespace intrusive
+
+namespace detail {
+
+// The cursors are addresses of hooks, 0 for an idle lane, and the next_
+// pointer is loaded directly from the hook.
+static_assert(std::is_standard_layout_v<intrusive::forward_list_hook> &&
+              sizeof(intrusive::forward_list_hook) == sizeof(std::uintptr_t));
+
+template<typename> struct lockstep_list;
+
+template<typename T, auto Hook, bool TrackTail> struct lockstep_list<intrusive::forward_list<T, Hook, TrackTail>> {
+  static_assert(std::is_same_v<std::remove_reference_t<decltype(std::declval<T&>().*Hook)>,
+                               intrusive::forward_list_hook>,
+                "lockstep lookups require pointer-based hooks");
+  static constexpr auto hook = Hook;
+};
+
+template<typename> struct lockstep_key;
+
+template<typename Structure, typename Key> struct lockstep_key<Key Structure::*> {
+  using structure = Structure;
+  using type = std::remove_cv_t<Key>;
+};
+
+struct lockstep_masks {
+  unsigned found;
+  unsigned exhausted;
+};
+
+/// \brief Advances all cursors by one element
+///
+/// Lanes whose element has the key they are looking for are reported as found
+/// and their cursors stay at the element. Lanes that reached the end of their
+/// lists are reported as exhausted and become idle. All the other cursors are
+/// moved to the next element.
+///
+/// \tparam KeySize size of the key in bytes, 4 or 8
+/// \param hooks cursors, i.e. addresses of hooks, 0 for idle lanes
+/// \param keys looked up keys, zero extended to 64 bits
+/// \param key_offset offset of the key relative to the hook
+template<std::size_t KeySize>
+lockstep_masks lockstep_step(std::uint64_t* hooks, std::uint64_t const* keys, std::ptrdiff_t key_offset) noexcept {
+#if PLEIONE_LOCKSTEP_AVX512 || PLEIONE_LOCKSTEP_AVX2
+  static_assert(sizeof(intrusive::forward_list_hook) == sizeof(std::uint64_t));
+#endif
+#if PLEIONE_LOCKSTEP_AVX512
+  auto current = _mm512_load_si512(hooks);
+  auto zero = _mm512_setzero_si512();
+  auto active = _mm512_test_epi64_mask(current, current);
+  auto addresses = _mm512_add_epi64(current, _mm512_set1_epi64(key_offset));
+  __m512i values;
+  if constexpr (KeySize == 8) {
+    values = _mm512_mask_i64gather_epi64(zero, active, addresses, nullptr, 1);
+  } else {
+    auto narrow = _mm512_mask_i64gather_epi32(_mm256_setzero_si256(), active, addresses, nullptr, 1);
+    values = _mm512_maskz_cvtepu32_epi64(active, narrow);
+  }
+  auto found = _mm512_mask_cmpeq_epi64_mask(active, values, _mm512_load_si512(keys));
+  auto walking = __mmask8(active & ~found);
+  auto next = _mm512_mask_i64gather_epi64(zero, walking, current, nullptr, 1);
+  _mm512_store_si512(hooks, _mm512_mask_mov_epi64(next, found, current));
+  return {found, _mm512_mask_cmpeq_epi64_mask(walking, next, zero)};
+#elif PLEIONE_LOCKSTEP_AVX2
+  auto current = _mm256_load_si256(reinterpret_cast<__m256i const*>(hooks));
+  auto zero = _mm256_setzero_si256();
+  auto active = _mm256_xor_si256(_mm256_cmpeq_epi64(current, zero), _mm256_set1_epi64x(-1));
+  auto addresses = _mm256_add_epi64(current, _mm256_set1_epi64x(key_offset));
+  __m256i values;
+  if constexpr (KeySize == 8) {
+    values = _mm256_mask_i64gather_epi64(zero, nullptr, addresses, active, 1);
+  } else {
+    auto low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+    auto narrow = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(active, low_halves));
+    values = _mm256_cvtepu32_epi64(_mm256_mask_i64gather_epi32(_mm_setzero_si128(), nullptr, addresses, narrow, 1));
+  }
+  auto keys_vector = _mm256_load_si256(reinterpret_cast<__m256i const*>(keys));
+  auto found = _mm256_and_si256(_mm256_cmpeq_epi64(values, keys_vector), active);
+  auto walking = _mm256_andnot_si256(found, active);
+  auto next = _mm256_mask_i64gather_epi64(zero, nullptr, current, walking, 1);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(hooks), _mm256_blendv_epi8(next, current, found));
+  auto exhausted = _mm256_and_si256(walking, _mm256_cmpeq_epi64(next, zero));
+  return {unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(found))),
+          unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(exhausted)))};
+#else
+  auto masks = lockstep_masks{0, 0};
+  for (auto lane = std::size_t(0); lane < intrusive::lockstep_width; ++lane) {
+    if (!hooks[lane]) { continue; }
+    auto value = std::conditional_t<KeySize == 8, std::uint64_t, std::uint32_t>();
+    auto hook = std::uintptr_t(hooks[lane]);
+    std::memcpy(&value, reinterpret_cast<void const*>(hook + key_offset), sizeof(value));
+    if (value == keys[lane]) {
+      masks.found |= 1u << lane;
+      continue;
+    }
+    auto next = std::uintptr_t();
+    std::memcpy(&next, reinterpret_cast<void const*>(hook), sizeof(next));
+    hooks[lane] = next;
+    if (!next) { masks.exhausted |= 1u << lane; }
+  }
+  return masks;
+#endif
+}
+
+} // namespace detail
+
+namespace intrusive {
+
+/// \brief Looks up a batch of keys, each in its own forward_list
+///
+/// For each list of the batch finds the first element whose `Key` member is
+/// equal to the corresponding key, as a chained hash table lookup would do.
+/// The lists are walked in lockstep, `lockstep_width` of them at a time:
+/// every step loads the keys and the next pointers of the current elements
+/// of all lanes, so that their cache misses overlap.
+/// Lanes that finish pick up the next list of the batch.
+///
+/// The implementation is selected at compile time. If `PLEIONE_LOCKSTEP_GATHER`
+/// is defined to 1 and AVX-512 or AVX2 is enabled on x86-64 the keys and the
+/// next pointers are fetched with gathers, otherwise scalar code walks the
+/// lanes one after another, which still keeps the misses of all lanes in
+/// flight.
+///
+/// \note The only supported predicate is key equality, which the vector
+/// implementations compare with a single instruction.
+///
+/// \tparam Key pointer to the key member, a 32- or 64-bit integer
+/// \param first beginning of the batch of forward_lists
+/// \param last end of the batch of forward_lists
+/// \param keys beginning of the keys, one per list
+/// \param out beginning of the results, one per list; forward iterator to
+/// pointers to the elements, which are set to null if there is no match
+/// \returns iterator past the last result
+template<auto Key, typename ListIterator, typename KeyIterator, typename OutputIterator>
+OutputIterator find_lockstep(ListIterator first, ListIterator last, KeyIterator keys, OutputIterator out) {
+  using list_type = std::remove_cv_t<std::remove_reference_t<decltype(*first)>>;
+  using pointer = decltype(&*std::begin(*first));
+  using key_traits = detail::lockstep_key<decltype(Key)>;
+  using key_type = typename key_traits::type;
+  static_assert(std::is_same_v<typename key_traits::structure, typename list_type::value_type>);
+  static_assert(std::is_integral_v<key_type> && (sizeof(key_type) == 4 || sizeof(key_type) == 8),
+                "keys have to be 32- or 64-bit integers");
+
+  using value_type = typename list_type::value_type;
+  auto hook_offset = detail::offset_of<value_type, detail::lockstep_list<list_type>::hook>();
+  auto key_offset = detail::offset_of<value_type, Key>() - hook_offset;
+
+  alignas(64) std::uint64_t hooks[lockstep_width] = {};
+  alignas(64) std::uint64_t queries[lockstep_width] = {};
+  OutputIterator slots[lockstep_width];
+
+  auto refill = [&](std::size_t lane) {
+    for (; first != last; ++first, ++keys, ++out) {
+      auto begin = std::begin(*first);
+      if (begin == std::end(*first)) {
+        *out = nullptr;
+        continue;
+      }
+      hooks[lane] = std::uint64_t(reinterpret_cast<std::uintptr_t>(&*begin)) + hook_offset;
+      queries[lane] = std::uint64_t(std::make_unsigned_t<key_type>(*keys));
+      slots[lane] = out;
+      ++first, ++keys, ++out;
+      return true;
+    }
+    hooks[lane] = 0;
+    return false;
+  };
+
+  auto active = std::size_t(0);
+  for (auto lane = std::size_t(0); lane < lockstep_width; ++lane) { active += refill(lane); }
+
+  while (active) {
+    auto masks = detail::lockstep_step<sizeof(key_type)>(hooks, queries, key_offset);
+    for (auto lane = std::size_t(0); lane < lockstep_width; ++lane) {
+      if (masks.found & (1u << lane)) {
+        *slots[lane] = reinterpret_cast<pointer>(std::uintptr_t(hooks[lane] - hook_offset));
+      } else if (masks.exhausted & (1u << lane)) {
+        *slots[lane] = nullptr;
+      } else {
+        continue;
+      }
+      active -= !refill(lane);
+    }
+  }
+  return out;
+}
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
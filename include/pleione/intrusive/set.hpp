@@ -0,0 +1,586 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_SET_HPP
+#define PLEIONE_INTRUSIVE_SET_HPP
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "core.hpp"
+
+#include "../detail/container_of.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+class set_hook {
+  set_hook* parent_;
+  set_hook* left_;
+  set_hook* right_;
+  bool red_;
+
+private:
+  set_hook(set_hook* parent, set_hook* left, set_hook* right, bool red) noexcept
+      : parent_(parent), left_(left), right_(right), red_(red) {}
+
+  template<typename T, set_hook T::*, typename, bool> friend class basic_set;
+
+private:
+  // The header node keeps the root in parent_ and the leftmost and rightmost
+  // elements in left_ and right_. It is the only red node whose grandparent is
+  // itself, which lets next() and prev() step to and from end() without
+  // special-casing the container.
+  template<typename Hook> static Hook* minimum(Hook* x) noexcept {
+    while (x->left_) { x = x->left_; }
+    return x;
+  }
+  template<typename Hook> static Hook* maximum(Hook* x) noexcept {
+    while (x->right_) { x = x->right_; }
+    return x;
+  }
+
+  template<typename Hook> static Hook* next(Hook* x) noexcept {
+    if (x->right_) { return minimum<Hook>(x->right_); }
+    Hook* y = x->parent_;
+    while (x == y->right_) {
+      x = y;
+      y = y->parent_;
+    }
+    return x->right_ != y ? y : x;
+  }
+  template<typename Hook> static Hook* prev(Hook* x) noexcept {
+    if (x->red_ && x->parent_->parent_ == x) { return x->right_; }
+    if (x->left_) { return maximum<Hook>(x->left_); }
+    Hook* y = x->parent_;
+    while (x == y->left_) {
+      x = y;
+      y = y->parent_;
+    }
+    return y;
+  }
+
+  static void rotate_left(set_hook* x, set_hook*& root) noexcept {
+    auto y = x->right_;
+    x->right_ = y->left_;
+    if (y->left_) { y->left_->parent_ = x; }
+    y->parent_ = x->parent_;
+    if (x == root) {
+      root = y;
+    } else if (x == x->parent_->left_) {
+      x->parent_->left_ = y;
+    } else {
+      x->parent_->right_ = y;
+    }
+    y->left_ = x;
+    x->parent_ = y;
+  }
+
+  static void rotate_right(set_hook* x, set_hook*& root) noexcept {
+    auto y = x->left_;
+    x->left_ = y->right_;
+    if (y->right_) { y->right_->parent_ = x; }
+    y->parent_ = x->parent_;
+    if (x == root) {
+      root = y;
+    } else if (x == x->parent_->right_) {
+      x->parent_->right_ = y;
+    } else {
+      x->parent_->left_ = y;
+    }
+    y->right_ = x;
+    x->parent_ = y;
+  }
+
+  static void insert_and_rebalance(bool insert_left, set_hook* x, set_hook* p, set_hook& header) noexcept {
+    auto& root = header.parent_;
+    x->parent_ = p;
+    x->left_ = nullptr;
+    x->right_ = nullptr;
+    x->red_ = true;
+
+    if (insert_left) {
+      p->left_ = x;
+      if (p == &header) {
+        header.parent_ = x;
+        header.right_ = x;
+      } else if (p == header.left_) {
+        header.left_ = x;
+      }
+    } else {
+      p->right_ = x;
+      if (p == header.right_) { header.right_ = x; }
+    }
+
+    while (x != root && x->parent_->red_) {
+      auto xpp = x->parent_->parent_;
+      if (x->parent_ == xpp->left_) {
+        auto y = xpp->right_;
+        if (y && y->red_) {
+          x->parent_->red_ = false;
+          y->red_ = false;
+          xpp->red_ = true;
+          x = xpp;
+        } else {
+          if (x == x->parent_->right_) {
+            x = x->parent_;
+            rotate_left(x, root);
+          }
+          x->parent_->red_ = false;
+          xpp->red_ = true;
+          rotate_right(xpp, root);
+        }
+      } else {
+        auto y = xpp->left_;
+        if (y && y->red_) {
+          x->parent_->red_ = false;
+          y->red_ = false;
+          xpp->red_ = true;
+          x = xpp;
+        } else {
+          if (x == x->parent_->left_) {
+            x = x->parent_;
+            rotate_right(x, root);
+          }
+          x->parent_->red_ = false;
+          xpp->red_ = true;
+          rotate_left(xpp, root);
+        }
+      }
+    }
+    root->red_ = false;
+  }
+
+  static void erase_and_rebalance(set_hook* z, set_hook& header) noexcept {
+    auto& root = header.parent_;
+    auto& leftmost = header.left_;
+    auto& rightmost = header.right_;
+    auto y = z;
+    set_hook* x = nullptr;
+    set_hook* x_parent = nullptr;
+
+    if (!y->left_) {
+      x = y->right_;
+    } else if (!y->right_) {
+      x = y->left_;
+    } else {
+      y = minimum(y->right_);
+      x = y->right_;
+    }
+
+    if (y != z) {
+      z->left_->parent_ = y;
+      y->left_ = z->left_;
+      if (y != z->right_) {
+        x_parent = y->parent_;
+        if (x) { x->parent_ = y->parent_; }
+        y->parent_->left_ = x;
+        y->right_ = z->right_;
+        z->right_->parent_ = y;
+      } else {
+        x_parent = y;
+      }
+      if (root == z) {
+        root = y;
+      } else if (z->parent_->left_ == z) {
+        z->parent_->left_ = y;
+      } else {
+        z->parent_->right_ = y;
+      }
+      y->parent_ = z->parent_;
+      std::swap(y->red_, z->red_);
+    } else {
+      x_parent = y->parent_;
+      if (x) { x->parent_ = y->parent_; }
+      if (root == z) {
+        root = x;
+      } else if (z->parent_->left_ == z) {
+        z->parent_->left_ = x;
+      } else {
+        z->parent_->right_ = x;
+      }
+      if (leftmost == z) { leftmost = z->right_ ? minimum(x) : z->parent_; }
+      if (rightmost == z) { rightmost = z->left_ ? maximum(x) : z->parent_; }
+    }
+
+    if (z->red_) { return; }
+
+    while (x != root && (!x || !x->red_)) {
+      if (x == x_parent->left_) {
+        auto w = x_parent->right_;
+        if (w->red_) {
+          w->red_ = false;
+          x_parent->red_ = true;
+          rotate_left(x_parent, root);
+          w = x_parent->right_;
+        }
+        if ((!w->left_ || !w->left_->red_) && (!w->right_ || !w->right_->red_)) {
+          w->red_ = true;
+          x = x_parent;
+          x_parent = x_parent->parent_;
+        } else {
+          if (!w->right_ || !w->right_->red_) {
+            w->left_->red_ = false;
+            w->red_ = true;
+            rotate_right(w, root);
+            w = x_parent->right_;
+          }
+          w->red_ = x_parent->red_;
+          x_parent->red_ = false;
+          if (w->right_) { w->right_->red_ = false; }
+          rotate_left(x_parent, root);
+          break;
+        }
+      } else {
+        auto w = x_parent->left_;
+        if (w->red_) {
+          w->red_ = false;
+          x_parent->red_ = true;
+          rotate_right(x_parent, root);
+          w = x_parent->left_;
+        }
+        if ((!w->right_ || !w->right_->red_) && (!w->left_ || !w->left_->red_)) {
+          w->red_ = true;
+          x = x_parent;
+          x_parent = x_parent->parent_;
+        } else {
+          if (!w->left_ || !w->left_->red_) {
+            w->right_->red_ = false;
+            w->red_ = true;
+            rotate_left(w, root);
+            w = x_parent->left_;
+          }
+          w->red_ = x_parent->red_;
+          x_parent->red_ = false;
+          if (w->left_) { w->left_->red_ = false; }
+          rotate_right(x_parent, root);
+          break;
+        }
+      }
+    }
+    if (x) { x->red_ = false; }
+  }
+
+public:
+  set_hook() = default;
+  set_hook(set_hook const&) = delete;
+  set_hook(set_hook&&) = delete;
+};
+
+template<typename T, set_hook T::*Hook, typename Compare, bool Unique> class basic_set {
+  set_hook header_ = {nullptr, &header_, &header_, true};
+  std::size_t size_ = 0;
+  Compare compare_;
+
+public:
+  using key_type = T;
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using key_compare = Compare;
+  using value_compare = Compare;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+public:
+  template<bool Constant> class basic_iterator {
+    using hook_type = std::conditional_t<Constant, set_hook const, set_hook>;
+    hook_type* current_ = nullptr;
+
+  private:
+    explicit basic_iterator(hook_type* hook) noexcept : current_(hook) {}
+
+    friend class basic_set;
+
+  public:
+    using value_type = std::conditional_t<Constant, T const, T>;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    basic_iterator() = default;
+
+    operator basic_iterator<true>() const noexcept { return basic_iterator<true>(current_); }
+
+    reference operator*() const noexcept { return detail::container_of<value_type, Hook>(*current_); }
+    pointer operator->() const noexcept { return &detail::container_of<value_type, Hook>(*current_); }
+
+    basic_iterator& operator++() noexcept {
+      current_ = set_hook::next(current_);
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      auto it = *this;
+      operator++();
+      return it;
+    }
+
+    basic_iterator& operator--() noexcept {
+      current_ = set_hook::prev(current_);
+      return *this;
+    }
+    basic_iterator operator--(int) noexcept {
+      auto it = *this;
+      operator--();
+      return it;
+    }
+
+    bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
+    bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using insert_return_type = std::conditional_t<Unique, std::pair<iterator, bool>, iterator>;
+
+private:
+  static T& value(set_hook* hook) noexcept { return detail::container_of<T, Hook>(*hook); }
+  static T const& value(set_hook const* hook) noexcept {
+    return detail::container_of<T const, Hook>(*hook);
+  }
+
+  void take(basic_set& other) noexcept {
+    size_ = other.size_;
+    if (PLEIONE_UNLIKELY(!other.empty())) {
+      header_.parent_ = other.header_.parent_;
+      header_.left_ = other.header_.left_;
+      header_.right_ = other.header_.right_;
+      header_.parent_->parent_ = &header_;
+      other.clear();
+    } else {
+      clear();
+    }
+  }
+
+  template<typename Key> set_hook const* lower_bound_hook(Key const& key) const noexcept {
+    set_hook const* x = header_.parent_;
+    set_hook const* y = &header_;
+    while (x) {
+      if (!compare_(value(x), key)) {
+        y = x;
+        x = x->left_;
+      } else {
+        x = x->right_;
+      }
+    }
+    return y;
+  }
+
+  template<typename Key> set_hook const* upper_bound_hook(Key const& key) const noexcept {
+    set_hook const* x = header_.parent_;
+    set_hook const* y = &header_;
+    while (x) {
+      if (compare_(key, value(x))) {
+        y = x;
+        x = x->left_;
+      } else {
+        x = x->right_;
+      }
+    }
+    return y;
+  }
+
+  iterator mutable_iterator(set_hook const* hook) noexcept { return iterator(const_cast<set_hook*>(hook)); }
+
+public:
+  basic_set() = default;
+  explicit basic_set(Compare const& compare) : compare_(compare) {}
+
+  template<typename ForwardIt> basic_set(ForwardIt first, ForwardIt last, Compare const& compare = Compare())
+      : compare_(compare) {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    insert(first, last);
+  }
+
+  basic_set(basic_set const&) = delete;
+  basic_set(basic_set&& other) noexcept : compare_(std::move(other.compare_)) { take(other); }
+
+  basic_set& operator=(basic_set const&) = delete;
+  basic_set& operator=(basic_set&& other) noexcept {
+    if (PLEIONE_LIKELY(this != &other)) {
+      compare_ = std::move(other.compare_);
+      take(other);
+    }
+    return *this;
+  }
+
+  key_compare key_comp() const { return compare_; }
+  value_compare value_comp() const { return compare_; }
+
+  T& front() noexcept {
+    PLEIONE_ASSERT(size_);
+    return value(header_.left_);
+  }
+  T const& front() const noexcept {
+    PLEIONE_ASSERT(size_);
+    return value(static_cast<set_hook const*>(header_.left_));
+  }
+
+  T& back() noexcept {
+    PLEIONE_ASSERT(size_);
+    return value(header_.right_);
+  }
+  T const& back() const noexcept {
+    PLEIONE_ASSERT(size_);
+    return value(static_cast<set_hook const*>(header_.right_));
+  }
+
+  iterator begin() noexcept { return iterator(header_.left_); }
+  const_iterator begin() const noexcept { return const_iterator(header_.left_); }
+  iterator end() noexcept { return iterator(&header_); }
+  const_iterator end() const noexcept { return const_iterator(&header_); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  void clear() noexcept {
+    header_.parent_ = nullptr;
+    header_.left_ = &header_;
+    header_.right_ = &header_;
+    size_ = 0;
+  }
+
+  insert_return_type insert(T& object) {
+    auto& hook = object.*Hook;
+    auto x = header_.parent_;
+    auto y = &header_;
+    if constexpr (Unique) {
+      auto less = true;
+      while (x) {
+        y = x;
+        less = compare_(object, value(x));
+        x = less ? x->left_ : x->right_;
+      }
+      auto j = y;
+      if (less) {
+        if (j == header_.left_) {
+          set_hook::insert_and_rebalance(true, &hook, y, header_);
+          ++size_;
+          return {iterator(&hook), true};
+        }
+        j = set_hook::prev(j);
+      }
+      if (!compare_(value(j), object)) { return {iterator(j), false}; }
+      set_hook::insert_and_rebalance(y == &header_ || compare_(object, value(y)), &hook, y, header_);
+      ++size_;
+      return {iterator(&hook), true};
+    } else {
+      while (x) {
+        y = x;
+        x = compare_(object, value(x)) ? x->left_ : x->right_;
+      }
+      set_hook::insert_and_rebalance(y == &header_ || compare_(object, value(y)), &hook, y, header_);
+      ++size_;
+      return iterator(&hook);
+    }
+  }
+
+  template<typename ForwardIt> void insert(ForwardIt first, ForwardIt last) {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    using std::for_each;
+    for_each(first, last, [&](T& object) { insert(object); });
+  }
+
+  iterator erase(iterator position) noexcept {
+    PLEIONE_ASSERT(size_);
+    auto next = std::next(position);
+    set_hook::erase_and_rebalance(position.current_, header_);
+    --size_;
+    return next;
+  }
+
+  iterator erase(iterator first, iterator last) noexcept {
+    if (first == begin() && last == end()) {
+      clear();
+      return end();
+    }
+    while (first != last) { first = erase(first); }
+    return last;
+  }
+
+  iterator erase(T& object) noexcept { return erase(iterator(&(object.*Hook))); }
+
+  template<typename Key> iterator lower_bound(Key const& key) { return mutable_iterator(lower_bound_hook(key)); }
+  template<typename Key> const_iterator lower_bound(Key const& key) const {
+    return const_iterator(lower_bound_hook(key));
+  }
+
+  template<typename Key> iterator upper_bound(Key const& key) { return mutable_iterator(upper_bound_hook(key)); }
+  template<typename Key> const_iterator upper_bound(Key const& key) const {
+    return const_iterator(upper_bound_hook(key));
+  }
+
+  template<typename Key> std::pair<iterator, iterator> equal_range(Key const& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template<typename Key> std::pair<const_iterator, const_iterator> equal_range(Key const& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template<typename Key> iterator find(Key const& key) {
+    auto it = lower_bound(key);
+    return it == end() || compare_(key, *it) ? end() : it;
+  }
+  template<typename Key> const_iterator find(Key const& key) const {
+    auto it = lower_bound(key);
+    return it == end() || compare_(key, *it) ? end() : it;
+  }
+
+  template<typename Key> size_type count(Key const& key) const {
+    if constexpr (Unique) {
+      return find(key) != end();
+    } else {
+      auto [first, last] = equal_range(key);
+      return size_type(std::distance(first, last));
+    }
+  }
+
+  template<typename Key> bool contains(Key const& key) const { return find(key) != end(); }
+};
+
+template<typename T, set_hook T::*Hook, typename Compare = std::less<T>>
+using set = basic_set<T, Hook, Compare, true>;
+
+template<typename T, set_hook T::*Hook, typename Compare = std::less<T>>
+using multiset = basic_set<T, Hook, Compare, false>;
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
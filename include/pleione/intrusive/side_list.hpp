@@ -0,0 +1,337 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_SIDE_LIST_HPP
+#define PLEIONE_INTRUSIVE_SIDE_LIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "core.hpp"
+
+#include "../detail/prefetch.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// \brief Hook of intrusive::side_list
+///
+/// Side hooks are not members of the elements. They form an array parallel to
+/// the array of the elements, the hook of the element in slot `i` being the
+/// `i`-th one, and link the slots with 32-bit indices. Each hook also holds a
+/// copy of the key of its element, so that the list can be searched without
+/// accessing the elements at all.
+///
+/// \tparam Key type of the keys
+template<typename Key> class side_list_hook {
+  std::uint32_t next_;
+  std::uint32_t prev_;
+  Key key_;
+
+  template<typename, typename> friend class side_list;
+
+public:
+  side_list_hook() = default;
+  side_list_hook(side_list_hook const&) = delete;
+  side_list_hook(side_list_hook&&) = delete;
+};
+
+/// \brief Intrusive bidirectional list with hooks stored apart from the elements
+///
+/// The elements live in an array, e.g. a `std::vector`, and are linked through
+/// a parallel array of side_list_hook. Walking the list, or looking up a key,
+/// touches only the dense array of hooks, while the elements, which may be
+/// much larger, are accessed only when they are dereferenced. Several lists
+/// may share the same arrays as long as each element is in at most one of
+/// them.
+///
+/// The prefetching algorithms prefetch the hook and the first cache line of
+/// the next elements, or the data selected by `prefetch<...>::members` and
+/// `prefetch<...>::object`.
+///
+/// \tparam T type of the elements
+/// \tparam Key type of the keys kept in the hooks
+template<typename T, typename Key> class side_list {
+  using hook_type = side_list_hook<Key>;
+
+  static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+  T* objects_;
+  hook_type* hooks_;
+  std::uint32_t head_ = npos;
+  std::uint32_t tail_ = npos;
+  std::size_t size_ = 0;
+
+public:
+  using value_type = T;
+  using key_type = Key;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+public:
+  template<bool Constant> class basic_iterator {
+    using object_type = std::conditional_t<Constant, T const, T>;
+    using hook_type = std::conditional_t<Constant, typename side_list::hook_type const, typename side_list::hook_type>;
+    object_type* objects_ = nullptr;
+    hook_type* hooks_ = nullptr;
+    std::uint32_t current_ = npos;
+
+  private:
+    basic_iterator(object_type* objects, hook_type* hooks, std::uint32_t current) noexcept
+        : objects_(objects), hooks_(hooks), current_(current) {}
+
+    friend class side_list;
+
+  public:
+    using value_type = object_type;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    basic_iterator() = default;
+
+    operator basic_iterator<true>() const noexcept { return basic_iterator<true>(objects_, hooks_, current_); }
+
+    reference operator*() const noexcept { return objects_[current_]; }
+    pointer operator->() const noexcept { return objects_ + current_; }
+
+    /// Returns the key of the element, without accessing the element.
+    Key const& key() const noexcept { return hooks_[current_].key_; }
+    /// Returns the index of the element in the array of elements.
+    std::uint32_t slot() const noexcept { return current_; }
+
+    basic_iterator& operator++() noexcept {
+      current_ = hooks_[current_].next_;
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      auto it = *this;
+      operator++();
+      return it;
+    }
+
+    bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
+    bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
+
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_next() const noexcept {
+      auto next = hooks_[current_].next_;
+      if (next == npos) { return; }
+      PLEIONE_PREFETCH_HINT(hooks_ + next, Write, int(Locality));
+      auto object = reinterpret_cast<std::uintptr_t>(objects_ + next);
+      if constexpr (std::is_void_v<Target>) {
+        PLEIONE_PREFETCH_HINT(reinterpret_cast<void const*>(object), Write, int(Locality));
+      } else {
+        detail::prefetch_target<Locality, Write, T>(object, static_cast<Target*>(nullptr));
+      }
+    }
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+private:
+  std::uint32_t slot_of(T const& object) const noexcept {
+    auto slot = std::size_t(&object - objects_);
+    PLEIONE_ASSERT(slot < npos);
+    return std::uint32_t(slot);
+  }
+
+  // Links slot between previous and next, either of which may be npos.
+  void link(std::uint32_t previous, std::uint32_t slot, std::uint32_t next, Key key) noexcept {
+    auto& hook = hooks_[slot];
+    hook.next_ = next;
+    hook.prev_ = previous;
+    hook.key_ = std::move(key);
+    (previous == npos ? head_ : hooks_[previous].next_) = slot;
+    (next == npos ? tail_ : hooks_[next].prev_) = slot;
+    ++size_;
+  }
+
+  template<typename Iterator> static Iterator find_from(Iterator it, Key const& key) noexcept {
+    auto hooks = it.hooks_;
+    auto current = it.current_;
+    while (current != npos && !(hooks[current].key_ == key)) { current = hooks[current].next_; }
+    it.current_ = current;
+    return it;
+  }
+
+public:
+  /// \param objects array of the elements
+  /// \param hooks array of the hooks, of the same size as `objects`
+  side_list(T* objects, hook_type* hooks) noexcept : objects_(objects), hooks_(hooks) {}
+
+  side_list(side_list const&) = delete;
+  side_list(side_list&& other) noexcept
+      : objects_(other.objects_), hooks_(other.hooks_), head_(std::exchange(other.head_, npos)),
+        tail_(std::exchange(other.tail_, npos)), size_(std::exchange(other.size_, 0)) {}
+
+  side_list& operator=(side_list const&) = delete;
+  side_list& operator=(side_list&& other) noexcept {
+    objects_ = other.objects_;
+    hooks_ = other.hooks_;
+    head_ = std::exchange(other.head_, npos);
+    tail_ = std::exchange(other.tail_, npos);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  T& front() noexcept {
+    PLEIONE_ASSERT(!empty());
+    return objects_[head_];
+  }
+  T const& front() const noexcept {
+    PLEIONE_ASSERT(!empty());
+    return objects_[head_];
+  }
+
+  T& back() noexcept {
+    PLEIONE_ASSERT(!empty());
+    return objects_[tail_];
+  }
+  T const& back() const noexcept {
+    PLEIONE_ASSERT(!empty());
+    return objects_[tail_];
+  }
+
+  iterator begin() noexcept { return iterator(objects_, hooks_, head_); }
+  const_iterator begin() const noexcept { return const_iterator(objects_, hooks_, head_); }
+  iterator end() noexcept { return iterator(objects_, hooks_, npos); }
+  const_iterator end() const noexcept { return const_iterator(objects_, hooks_, npos); }
+
+  bool empty() const noexcept { return head_ == npos; }
+  size_type size() const noexcept { return size_; }
+
+  void clear() noexcept {
+    head_ = npos;
+    tail_ = npos;
+    size_ = 0;
+  }
+
+  /// Returns the key of a linked element, without accessing the element.
+  Key const& key(T const& object) const noexcept { return hooks_[slot_of(object)].key_; }
+
+  /// Returns an iterator to a linked element.
+  iterator iterator_to(T& object) noexcept { return iterator(objects_, hooks_, slot_of(object)); }
+  const_iterator iterator_to(T const& object) const noexcept {
+    return const_iterator(objects_, hooks_, slot_of(object));
+  }
+
+  /// Inserts an element before position, returns an iterator to it.
+  iterator insert(const_iterator position, T& object, Key key) noexcept {
+    auto slot = slot_of(object);
+    auto previous = position.current_ == npos ? tail_ : hooks_[position.current_].prev_;
+    link(previous, slot, position.current_, std::move(key));
+    return iterator(objects_, hooks_, slot);
+  }
+
+  /// Erases an element, returns an iterator to the one that followed it.
+  iterator erase(const_iterator position) noexcept {
+    auto& hook = hooks_[position.current_];
+    (hook.prev_ == npos ? head_ : hooks_[hook.prev_].next_) = hook.next_;
+    (hook.next_ == npos ? tail_ : hooks_[hook.next_].prev_) = hook.prev_;
+    --size_;
+    return iterator(objects_, hooks_, hook.next_);
+  }
+  iterator erase(T& object) noexcept { return erase(iterator_to(object)); }
+
+  void push_front(T& object, Key key) noexcept { link(npos, slot_of(object), head_, std::move(key)); }
+  void push_back(T& object, Key key) noexcept { link(tail_, slot_of(object), npos, std::move(key)); }
+
+  void pop_front() noexcept {
+    PLEIONE_ASSERT(!empty());
+    erase(begin());
+  }
+  void pop_back() noexcept {
+    PLEIONE_ASSERT(!empty());
+    erase(const_iterator(objects_, hooks_, tail_));
+  }
+
+  /// \brief Finds the first element with a given key
+  ///
+  /// Only the hooks are accessed.
+  ///
+  /// \returns iterator to the element, or end() if there is none
+  iterator find(Key const& key) noexcept { return find_from(begin(), key); }
+  const_iterator find(Key const& key) const noexcept { return find_from(begin(), key); }
+
+public:
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryFunction>
+  friend void for_each(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                       basic_iterator<Constant> last, UnaryFunction&& fn) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      fn(*it);
+      return false;
+    });
+  }
+  template<bool Constant, typename UnaryFunction>
+  friend void for_each(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryFunction&& fn) {
+    for_each(prefetch<true>{}, first, last, std::forward<UnaryFunction>(fn));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename U,
+           typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                            basic_iterator<Constant> last, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      init = binary_op(std::move(init), unary_op(*it));
+      return false;
+    });
+    return init;
+  }
+  template<bool Constant, typename U, typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(basic_iterator<Constant> first, basic_iterator<Constant> last, U init, BinaryOp&& binary_op,
+                            UnaryOp&& unary_op) {
+    return transform_reduce(prefetch<true>{}, first, last, std::move(init), std::forward<BinaryOp>(binary_op),
+                            std::forward<UnaryOp>(unary_op));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                                          basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return detail::prefetching_find<Depth, Locality, Write, Target>(
+        first, last, [&](basic_iterator<Constant> it) { return bool(pred(*it)); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                          UnaryPredicate&& pred) {
+    return find_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+};
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
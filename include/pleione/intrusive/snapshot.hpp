@@ -0,0 +1,233 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_SNAPSHOT_HPP
+#define PLEIONE_INTRUSIVE_SNAPSHOT_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace detail {
+
+struct snapshot_header {
+  static constexpr std::uint64_t expected_magic = 0x746f6873706e7370; // "psnpshot"
+  static constexpr std::uint64_t current_version = 1;
+
+  std::uint64_t magic;
+  std::uint64_t version;
+  std::uint64_t size;
+  std::uint64_t root;
+};
+
+} // namespace detail
+
+namespace intrusive {
+
+/// How the pages of a loaded snapshot are brought into memory.
+enum class snapshot_load {
+  /// Pages are read on first access.
+  lazy,
+  /// All pages are read when the snapshot is loaded.
+  populate,
+};
+
+/// \brief Memory region that can be saved to a file and mapped back
+///
+/// Objects are constructed in the region with a bump allocator, one of them
+/// can be marked as the root. The region is written to a file as is and
+/// loading maps the file privately, so that a warm restart costs page faults
+/// instead of rebuilding the data structures. Modifications of a loaded
+/// snapshot are not written back to the file unless it is saved again.
+///
+/// The region may be mapped at a different address than the one it was saved
+/// from, so all links between the objects have to be position independent:
+/// hooks with relative_links, or arena_links with the arena base set to
+/// data() after loading. Destructors of the objects are never run.
+///
+/// \note Snapshots use POSIX file and memory mapping functions. This header
+/// is not included by all.hpp.
+class snapshot {
+  static constexpr std::size_t data_offset = 64;
+  static_assert(sizeof(detail::snapshot_header) <= data_offset);
+
+  std::byte* data_ = nullptr;
+  std::size_t capacity_ = 0;
+
+private:
+  snapshot(void* data, std::size_t capacity) noexcept : data_(static_cast<std::byte*>(data)), capacity_(capacity) {}
+
+  detail::snapshot_header& header() noexcept { return *reinterpret_cast<detail::snapshot_header*>(data_); }
+  detail::snapshot_header const& header() const noexcept {
+    return *reinterpret_cast<detail::snapshot_header const*>(data_);
+  }
+
+public:
+  snapshot(snapshot const&) = delete;
+  snapshot(snapshot&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)), capacity_(std::exchange(other.capacity_, 0)) {}
+
+  snapshot& operator=(snapshot const&) = delete;
+  snapshot& operator=(snapshot&& other) noexcept {
+    if (this != &other) {
+      if (data_) { ::munmap(data_, capacity_); }
+      data_ = std::exchange(other.data_, nullptr);
+      capacity_ = std::exchange(other.capacity_, 0);
+    }
+    return *this;
+  }
+
+  ~snapshot() {
+    if (data_) { ::munmap(data_, capacity_); }
+  }
+
+  /// Creates an empty snapshot able to hold `capacity` bytes of objects.
+  static std::optional<snapshot> create(std::size_t capacity) noexcept {
+    auto size = data_offset + capacity;
+    auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) { return std::nullopt; }
+    auto s = snapshot(data, size);
+    s.header() = {detail::snapshot_header::expected_magic, detail::snapshot_header::current_version, data_offset, 0};
+    return s;
+  }
+
+  /// \brief Maps a snapshot saved by save()
+  ///
+  /// Returns an empty optional if the file cannot be mapped or does not
+  /// contain a snapshot. The capacity of the loaded snapshot is the size of
+  /// the file, so no more objects can be constructed in it.
+  static std::optional<snapshot> load(char const* path, snapshot_load mode = snapshot_load::lazy) noexcept {
+    auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return std::nullopt; }
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < data_offset) {
+      ::close(fd);
+      return std::nullopt;
+    }
+    auto size = std::size_t(st.st_size);
+    auto flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (mode == snapshot_load::populate) { flags |= MAP_POPULATE; }
+#endif
+    auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) { return std::nullopt; }
+    auto s = snapshot(data, size);
+    auto& hdr = s.header();
+    if (hdr.magic != detail::snapshot_header::expected_magic ||
+        hdr.version != detail::snapshot_header::current_version || hdr.size != size || hdr.root >= size) {
+      return std::nullopt;
+    }
+    return s;
+  }
+
+  /// \brief Writes the used part of the snapshot to a file
+  ///
+  /// The data is written to a temporary file which is flushed to disk and then
+  /// replaces `path`, so snapshots loaded from the previous version of the
+  /// file, including this one, remain valid, and a crash does not leave a
+  /// truncated snapshot behind. Returns false on failure.
+  bool save(char const* path) const {
+    auto temporary = std::string(path) + ".XXXXXX";
+    auto fd = ::mkstemp(temporary.data());
+    if (fd < 0) { return false; }
+    auto first = data_;
+    auto last = data_ + header().size;
+    auto ok = ::fchmod(fd, 0644) == 0;
+    while (ok && first != last) {
+      auto n = ::write(fd, first, std::size_t(last - first));
+      if (n < 0 && errno == EINTR) { continue; }
+      ok = n > 0;
+      if (ok) { first += n; }
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    ok = ok && ::rename(temporary.c_str(), path) == 0;
+    if (!ok) { ::unlink(temporary.c_str()); }
+    return ok;
+  }
+
+  /// Returns the address at which the snapshot is mapped.
+  std::byte* data() const noexcept { return data_; }
+  /// Returns the number of bytes used, including the snapshot header.
+  std::size_t size() const noexcept { return header().size; }
+  /// Returns the maximum size of the snapshot.
+  std::size_t capacity() const noexcept { return capacity_; }
+
+  /// Allocates uninitialised storage, returns nullptr if the snapshot is full.
+  void* allocate(std::size_t size, std::size_t alignment) noexcept {
+    auto& hdr = header();
+    auto offset = (hdr.size + alignment - 1) / alignment * alignment;
+    if (offset > capacity_ || size > capacity_ - offset) { return nullptr; }
+    hdr.size = offset + size;
+    return data_ + offset;
+  }
+
+  /// Constructs an object in the snapshot, returns nullptr if it is full.
+  template<typename T, typename... Args> T* construct(Args&&... args) noexcept {
+    auto ptr = allocate(sizeof(T), alignof(T));
+    return ptr ? new (ptr) T(std::forward<Args>(args)...) : nullptr;
+  }
+
+  /// Constructs `n` default-initialised objects, returns nullptr if the
+  /// snapshot is full.
+  template<typename T> T* construct_n(std::size_t n) noexcept {
+    if (n > capacity_ / sizeof(T)) { return nullptr; }
+    auto ptr = static_cast<T*>(allocate(sizeof(T) * n, alignof(T)));
+    if (ptr) { std::uninitialized_default_construct_n(ptr, n); }
+    return ptr;
+  }
+
+  /// Marks an object constructed in the snapshot as its root.
+  template<typename T> void set_root(T& root) noexcept {
+    auto ptr = reinterpret_cast<std::byte*>(&root);
+    PLEIONE_ASSERT(ptr >= data_ + data_offset && ptr < data_ + header().size);
+    header().root = std::uint64_t(ptr - data_);
+  }
+
+  /// Returns the root object, or nullptr if it has not been set.
+  template<typename T> T* root() const noexcept {
+    auto offset = header().root;
+    return offset ? reinterpret_cast<T*>(data_ + offset) : nullptr;
+  }
+};
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
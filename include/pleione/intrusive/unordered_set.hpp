@@ -0,0 +1,351 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_UNORDERED_SET_HPP
+#define PLEIONE_INTRUSIVE_UNORDERED_SET_HPP
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "core.hpp"
+#include "forward_list.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// \brief Chained hash table with buckets made of forward_list
+///
+/// Bucket count is always a power of two. When the table grows the old bucket
+/// array is kept alongside the new one and its buckets are migrated a few at
+/// a time by each subsequent insert, so no single insertion pays for moving
+/// the whole table. Lookups consult both arrays while a migration is pending.
+///
+/// \note Inserting may invalidate iterators, erasing invalidates only the
+/// iterators to the erased element.
+///
+/// \tparam T type of the elements
+/// \tparam Hook pointer to the forward_list_hook member of T
+/// \tparam KeyOf function object returning the key of an element
+/// \tparam Hash hash function for the keys
+/// \tparam KeyEqual equality comparison for the keys
+template<typename T, forward_list_hook T::*Hook, typename KeyOf,
+         typename Hash = std::hash<std::decay_t<std::invoke_result_t<KeyOf, T const&>>>,
+         typename KeyEqual = std::equal_to<>>
+class unordered_set {
+  using bucket_type = forward_list<T, Hook>;
+
+  static constexpr std::size_t minimum_bucket_count = 8;
+  static constexpr std::size_t rehash_step = 4;
+
+  struct table {
+    std::unique_ptr<bucket_type[]> buckets_;
+    std::size_t mask_ = 0;
+
+    std::size_t bucket_count() const noexcept { return buckets_ ? mask_ + 1 : 0; }
+  };
+
+  table current_;
+  table previous_;
+  std::size_t rehash_position_ = 0;
+  std::size_t size_ = 0;
+  KeyOf key_of_;
+  Hash hash_;
+  KeyEqual key_equal_;
+
+public:
+  using key_type = std::decay_t<std::invoke_result_t<KeyOf, T const&>>;
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+public:
+  template<bool Constant> class basic_iterator {
+    using owner_type = std::conditional_t<Constant, unordered_set const, unordered_set>;
+    using bucket_iterator =
+        std::conditional_t<Constant, typename bucket_type::const_iterator, typename bucket_type::iterator>;
+    owner_type* owner_ = nullptr;
+    std::size_t position_ = 0;
+    bucket_iterator current_ = {};
+
+  private:
+    basic_iterator(owner_type* owner, std::size_t position, bucket_iterator current) noexcept
+        : owner_(owner), position_(position), current_(current) {}
+
+    friend class unordered_set;
+
+  public:
+    using value_type = std::conditional_t<Constant, T const, T>;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    basic_iterator() = default;
+
+    operator basic_iterator<true>() const noexcept { return basic_iterator<true>(owner_, position_, current_); }
+
+    reference operator*() const noexcept { return *current_; }
+    pointer operator->() const noexcept { return &*current_; }
+
+    basic_iterator& operator++() noexcept {
+      if (++current_ == bucket_iterator()) { *this = owner_->template first_from<basic_iterator>(position_ + 1); }
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      auto it = *this;
+      operator++();
+      return it;
+    }
+
+    bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
+    bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+private:
+  // Bucket positions [0, previous_.bucket_count()) refer to the array that is
+  // being migrated, the following ones to the current array.
+  std::size_t position_count() const noexcept { return previous_.bucket_count() + current_.bucket_count(); }
+
+  bucket_type& bucket_at(std::size_t position) noexcept {
+    auto previous_count = previous_.bucket_count();
+    return position < previous_count ? previous_.buckets_[position] : current_.buckets_[position - previous_count];
+  }
+  bucket_type const& bucket_at(std::size_t position) const noexcept {
+    return const_cast<unordered_set&>(*this).bucket_at(position);
+  }
+
+  template<typename Iterator> Iterator first_from(std::size_t position) const noexcept {
+    auto owner = const_cast<unordered_set*>(this);
+    for (auto n = position_count(); position < n; ++position) {
+      auto& bucket = owner->bucket_at(position);
+      if (!bucket.empty()) { return Iterator(owner, position, bucket.begin()); }
+    }
+    return Iterator();
+  }
+
+  template<typename Function> bool for_each_candidate(std::size_t hash, Function&& fn) {
+    if (previous_.buckets_) {
+      auto position = hash & previous_.mask_;
+      if (position >= rehash_position_ && fn(position)) { return true; }
+    }
+    return current_.buckets_ && fn(previous_.bucket_count() + (hash & current_.mask_));
+  }
+
+  template<typename Predicate>
+  std::pair<std::size_t, typename bucket_type::iterator> find_before(std::size_t hash, Predicate&& pred) {
+    auto result = std::pair<std::size_t, typename bucket_type::iterator>();
+    for_each_candidate(hash, [&](std::size_t position) {
+      auto& bucket = bucket_at(position);
+      for (auto before = bucket.before_begin(), it = bucket.begin(); it != bucket.end(); before = it++) {
+        if (pred(*it)) {
+          result = {position, before};
+          return true;
+        }
+      }
+      return false;
+    });
+    return result;
+  }
+
+  static table make_table(std::size_t bucket_count) {
+    auto t = table();
+    t.buckets_ = std::make_unique<bucket_type[]>(bucket_count);
+    t.mask_ = bucket_count - 1;
+    return t;
+  }
+
+  static std::size_t round_up_bucket_count(std::size_t n) noexcept {
+    auto count = minimum_bucket_count;
+    while (count < n) { count *= 2; }
+    return count;
+  }
+
+  void migrate_bucket(std::size_t position) noexcept {
+    auto& from = previous_.buckets_[position];
+    while (!from.empty()) {
+      auto& object = from.front();
+      from.pop_front();
+      current_.buckets_[hash_(key_of_(object)) & current_.mask_].push_front(object);
+    }
+  }
+
+  void rehash_some(std::size_t steps) noexcept {
+    if (PLEIONE_LIKELY(!previous_.buckets_)) { return; }
+    auto count = previous_.bucket_count();
+    for (auto i = 0u; i < steps && rehash_position_ < count; ++i) { migrate_bucket(rehash_position_++); }
+    if (rehash_position_ == count) {
+      previous_ = table();
+      rehash_position_ = 0;
+    }
+  }
+
+  void rehash_all() noexcept { rehash_some(previous_.bucket_count()); }
+
+  void start_rehash(std::size_t bucket_count) {
+    auto next = make_table(bucket_count);
+    rehash_all();
+    previous_ = std::exchange(current_, std::move(next));
+    if (!previous_.buckets_) { return; }
+    rehash_position_ = 0;
+  }
+
+public:
+  unordered_set() = default;
+  explicit unordered_set(size_type bucket_count, Hash const& hash = Hash(), KeyEqual const& equal = KeyEqual(),
+                         KeyOf const& key_of = KeyOf())
+      : key_of_(key_of), hash_(hash), key_equal_(equal) {
+    if (bucket_count) { current_ = make_table(round_up_bucket_count(bucket_count)); }
+  }
+
+  unordered_set(unordered_set const&) = delete;
+  unordered_set(unordered_set&& other) noexcept
+      : current_(std::move(other.current_)), previous_(std::move(other.previous_)),
+        rehash_position_(std::exchange(other.rehash_position_, 0)), size_(std::exchange(other.size_, 0)),
+        key_of_(std::move(other.key_of_)), hash_(std::move(other.hash_)), key_equal_(std::move(other.key_equal_)) {
+    other.current_ = table();
+    other.previous_ = table();
+  }
+
+  unordered_set& operator=(unordered_set const&) = delete;
+  unordered_set& operator=(unordered_set&& other) noexcept {
+    if (PLEIONE_LIKELY(this != &other)) {
+      current_ = std::exchange(other.current_, table());
+      previous_ = std::exchange(other.previous_, table());
+      rehash_position_ = std::exchange(other.rehash_position_, 0);
+      size_ = std::exchange(other.size_, 0);
+      key_of_ = std::move(other.key_of_);
+      hash_ = std::move(other.hash_);
+      key_equal_ = std::move(other.key_equal_);
+    }
+    return *this;
+  }
+
+  iterator begin() noexcept { return first_from<iterator>(rehash_position_); }
+  const_iterator begin() const noexcept { return first_from<const_iterator>(rehash_position_); }
+  iterator end() noexcept { return iterator(); }
+  const_iterator end() const noexcept { return const_iterator(); }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type bucket_count() const noexcept { return current_.bucket_count(); }
+
+  float load_factor() const noexcept { return bucket_count() ? float(size_) / bucket_count() : 0.f; }
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return key_equal_; }
+
+  void clear() noexcept {
+    previous_ = table();
+    rehash_position_ = 0;
+    for (auto i = 0u; i < current_.bucket_count(); ++i) { current_.buckets_[i].clear(); }
+    size_ = 0;
+  }
+
+  void reserve(size_type count) {
+    if (count <= bucket_count()) { return; }
+    start_rehash(round_up_bucket_count(count));
+    rehash_all();
+  }
+
+  std::pair<iterator, bool> insert(T& object) {
+    auto&& key = key_of_(object);
+    auto hash = hash_(key);
+    auto [position, before] = find_before(hash, [&](T const& other) { return key_equal_(key_of_(other), key); });
+    if (before != typename bucket_type::iterator()) { return {iterator(this, position, std::next(before)), false}; }
+
+    if (size_ >= bucket_count()) { start_rehash(round_up_bucket_count(bucket_count() * 2)); }
+    rehash_some(rehash_step);
+
+    position = previous_.bucket_count() + (hash & current_.mask_);
+    auto& bucket = bucket_at(position);
+    bucket.push_front(object);
+    ++size_;
+    return {iterator(this, position, bucket.begin()), true};
+  }
+
+  template<typename ForwardIt> void insert(ForwardIt first, ForwardIt last) {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    using std::for_each;
+    for_each(first, last, [&](T& object) { insert(object); });
+  }
+
+  iterator erase(iterator position) noexcept {
+    PLEIONE_ASSERT(size_);
+    auto next = std::next(position);
+    auto& bucket = bucket_at(position.position_);
+    auto before = bucket.before_begin();
+    while (std::next(before) != position.current_) { ++before; }
+    bucket.erase_after(before);
+    --size_;
+    return next;
+  }
+
+  void erase(T& object) {
+    auto [position, before] = find_before(hash_(key_of_(object)), [&](T const& other) { return &other == &object; });
+    PLEIONE_ASSERT(before != typename bucket_type::iterator());
+    bucket_at(position).erase_after(before);
+    --size_;
+  }
+
+  size_type erase(key_type const& key) {
+    auto [position, before] = find_before(hash_(key), [&](T const& other) { return key_equal_(key_of_(other), key); });
+    if (before == typename bucket_type::iterator()) { return 0; }
+    bucket_at(position).erase_after(before);
+    --size_;
+    return 1;
+  }
+
+  template<typename Key> iterator find(Key const& key) {
+    auto [position, before] = find_before(hash_(key), [&](T const& other) { return key_equal_(key_of_(other), key); });
+    if (before == typename bucket_type::iterator()) { return end(); }
+    return iterator(this, position, std::next(before));
+  }
+  template<typename Key> const_iterator find(Key const& key) const {
+    return const_cast<unordered_set&>(*this).find(key);
+  }
+
+  template<typename Key> size_type count(Key const& key) const { return find(key) != end(); }
+
+  template<typename Key> bool contains(Key const& key) const { return find(key) != end(); }
+};
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
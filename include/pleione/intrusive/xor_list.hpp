@@ -0,0 +1,375 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_INTRUSIVE_XOR_LIST_HPP
+#define PLEIONE_INTRUSIVE_XOR_LIST_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "core.hpp"
+
+#include "../detail/container_of.hpp"
+#include "../detail/prefetch.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+namespace intrusive {
+
+/// \brief Hook of intrusive::xor_list
+///
+/// The hook is a single word holding the exclusive or of the addresses of the
+/// previous and the next hook, null at the ends of the list.
+class xor_list_hook {
+  std::uintptr_t link_;
+
+private:
+  xor_list_hook* neighbour(xor_list_hook const* other) const noexcept {
+    return reinterpret_cast<xor_list_hook*>(link_ ^ reinterpret_cast<std::uintptr_t>(other));
+  }
+  void replace(xor_list_hook const* from, xor_list_hook const* to) noexcept {
+    link_ ^= reinterpret_cast<std::uintptr_t>(from) ^ reinterpret_cast<std::uintptr_t>(to);
+  }
+
+  template<typename T, auto> friend class xor_list;
+
+public:
+  xor_list_hook() = default;
+  xor_list_hook(xor_list_hook const&) = delete;
+  xor_list_hook(xor_list_hook&&) = delete;
+};
+
+/// \brief Intrusive XOR-linked bidirectional list
+///
+/// Each element has a one-word hook, half of the size of list_hook, and the
+/// list can be traversed in both directions. An element cannot be located in
+/// the list just from a reference to it though: iterators carry the previous
+/// hook as well, and only an iterator allows inserting or erasing in the
+/// middle of the list. The list can be reversed in constant time.
+///
+/// Inserting or erasing an element invalidates iterators to its neighbours
+/// and to the element following the inserted or erased one, including end()
+/// if it is the last one. For the same reason the functions passed to the
+/// algorithms must not unlink any elements.
+///
+/// \tparam T type of the elements
+/// \tparam Hook pointer to the xor_list_hook member of T
+template<typename T, auto Hook> class xor_list {
+  static_assert(std::is_same_v<std::remove_reference_t<decltype(std::declval<T&>().*Hook)>, xor_list_hook>,
+                "Hook has to point to an xor_list_hook member of T");
+
+  using hook_type = xor_list_hook;
+
+  hook_type* head_ = nullptr;
+  hook_type* tail_ = nullptr;
+  std::size_t size_ = 0;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+public:
+  template<bool Constant> class basic_iterator {
+    using hook_type = std::conditional_t<Constant, typename xor_list::hook_type const, typename xor_list::hook_type>;
+    hook_type* previous_ = nullptr;
+    hook_type* current_ = nullptr;
+
+  private:
+    basic_iterator(hook_type* previous, hook_type* current) noexcept : previous_(previous), current_(current) {}
+
+    friend class xor_list;
+
+  public:
+    using value_type = std::conditional_t<Constant, T const, T>;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    basic_iterator() = default;
+
+    operator basic_iterator<true>() const noexcept { return basic_iterator<true>(previous_, current_); }
+
+    reference operator*() const noexcept { return detail::container_of<value_type, Hook>(*current_); }
+    pointer operator->() const noexcept { return &detail::container_of<value_type, Hook>(*current_); }
+
+    basic_iterator& operator++() noexcept {
+      previous_ = std::exchange(current_, current_->neighbour(previous_));
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      auto it = *this;
+      operator++();
+      return it;
+    }
+
+    basic_iterator& operator--() noexcept {
+      current_ = std::exchange(previous_, previous_->neighbour(current_));
+      return *this;
+    }
+    basic_iterator operator--(int) noexcept {
+      auto it = *this;
+      operator--();
+      return it;
+    }
+
+    bool operator==(basic_iterator const& other) const noexcept { return current_ == other.current_; }
+    bool operator!=(basic_iterator const& other) const noexcept { return !(*this == other); }
+
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_next() const noexcept {
+      detail::prefetch_element<Locality, Write, Target, T>(detail::offset_of<T, Hook>(),
+                                                           current_->neighbour(previous_));
+    }
+    template<locality Locality = locality::high, bool Write = false, typename Target = void>
+    void prefetch_previous() const noexcept {
+      if (!previous_) { return; }
+      detail::prefetch_element<Locality, Write, Target, T>(detail::offset_of<T, Hook>(),
+                                                           previous_->neighbour(current_));
+    }
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+  // Links hook between previous and next, either of which may be null.
+  void link(hook_type* previous, hook_type& hook, hook_type* next) noexcept {
+    hook.link_ = reinterpret_cast<std::uintptr_t>(previous) ^ reinterpret_cast<std::uintptr_t>(next);
+    if (previous) {
+      previous->replace(next, &hook);
+    } else {
+      head_ = &hook;
+    }
+    if (next) {
+      next->replace(previous, &hook);
+    } else {
+      tail_ = &hook;
+    }
+    ++size_;
+  }
+
+public:
+  xor_list() = default;
+
+  template<typename ForwardIt> xor_list(ForwardIt first, ForwardIt last) noexcept {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    assign(first, last);
+  }
+
+  xor_list(xor_list const&) = delete;
+  xor_list(xor_list&& other) noexcept
+      : head_(std::exchange(other.head_, nullptr)), tail_(std::exchange(other.tail_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  xor_list& operator=(xor_list const&) = delete;
+  xor_list& operator=(xor_list&& other) noexcept {
+    head_ = std::exchange(other.head_, nullptr);
+    tail_ = std::exchange(other.tail_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  template<typename ForwardIt> void assign(ForwardIt first, ForwardIt last) noexcept {
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>);
+    clear();
+    using std::for_each;
+    for_each(first, last, [&](T& object) { push_back(object); });
+  }
+
+  T& front() noexcept {
+    PLEIONE_ASSERT(!empty());
+    return detail::container_of<T, Hook>(*head_);
+  }
+  T const& front() const noexcept {
+    PLEIONE_ASSERT(!empty());
+    return detail::container_of<T, Hook>(*head_);
+  }
+
+  T& back() noexcept {
+    PLEIONE_ASSERT(!empty());
+    return detail::container_of<T, Hook>(*tail_);
+  }
+  T const& back() const noexcept {
+    PLEIONE_ASSERT(!empty());
+    return detail::container_of<T, Hook>(*tail_);
+  }
+
+  iterator begin() noexcept { return iterator(nullptr, head_); }
+  const_iterator begin() const noexcept { return const_iterator(nullptr, head_); }
+  iterator end() noexcept { return iterator(tail_, nullptr); }
+  const_iterator end() const noexcept { return const_iterator(tail_, nullptr); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  bool empty() const noexcept { return !head_; }
+  size_type size() const noexcept { return size_; }
+
+  void clear() noexcept {
+    head_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+  /// Inserts an element before position, returns an iterator to it.
+  iterator insert(iterator position, T& object) noexcept {
+    auto& hook = object.*Hook;
+    link(position.previous_, hook, position.current_);
+    return iterator(position.previous_, &hook);
+  }
+
+  /// Erases an element, returns an iterator to the one that followed it.
+  iterator erase(iterator position) noexcept {
+    auto previous = position.previous_;
+    auto current = position.current_;
+    auto next = current->neighbour(previous);
+    if (previous) {
+      previous->replace(current, next);
+    } else {
+      head_ = next;
+    }
+    if (next) {
+      next->replace(current, previous);
+    } else {
+      tail_ = previous;
+    }
+    --size_;
+    return iterator(previous, next);
+  }
+
+  void push_front(T& object) noexcept { link(nullptr, object.*Hook, head_); }
+  void push_back(T& object) noexcept { link(tail_, object.*Hook, nullptr); }
+
+  void pop_front() noexcept {
+    PLEIONE_ASSERT(!empty());
+    erase(begin());
+  }
+  void pop_back() noexcept {
+    PLEIONE_ASSERT(!empty());
+    erase(std::prev(end()));
+  }
+
+  /// Moves all elements of other before position.
+  void splice(iterator position, xor_list& other) noexcept {
+    splice(position, std::move(other));
+    other.clear();
+  }
+  void splice(iterator position, xor_list&& other) noexcept {
+    if (PLEIONE_UNLIKELY(other.empty())) { return; }
+    auto previous = position.previous_;
+    auto next = position.current_;
+    other.head_->replace(nullptr, previous);
+    other.tail_->replace(nullptr, next);
+    if (previous) {
+      previous->replace(next, other.head_);
+    } else {
+      head_ = other.head_;
+    }
+    if (next) {
+      next->replace(previous, other.tail_);
+    } else {
+      tail_ = other.tail_;
+    }
+    size_ += other.size_;
+  }
+
+  /// Reverses the order of the elements in constant time.
+  void reverse() noexcept { std::swap(head_, tail_); }
+
+public:
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryFunction>
+  friend void for_each(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                       basic_iterator<Constant> last, UnaryFunction&& fn) {
+    detail::prefetching_find<Depth, Locality, Write, Target>(first, last, [&](basic_iterator<Constant> it) {
+      fn(*it);
+      return false;
+    });
+  }
+  template<bool Constant, typename UnaryFunction>
+  friend void for_each(basic_iterator<Constant> first, basic_iterator<Constant> last, UnaryFunction&& fn) {
+    for_each(prefetch<true>{}, first, last, std::forward<UnaryFunction>(fn));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename U,
+           typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                            basic_iterator<Constant> last, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+    // As in list, the range is walked from both ends at once.
+    if (first == last) { return init; }
+
+    auto front = std::move(init);
+    auto back = unary_op(*--last);
+
+    while (first != last) {
+      if constexpr (Depth > 0) { first.template prefetch_next<Locality, Write, Target>(); }
+      front = binary_op(std::move(front), unary_op(*first++));
+
+      if (first == last) { break; }
+
+      --last;
+      if constexpr (Depth > 0) { last.template prefetch_previous<Locality, Write, Target>(); }
+      back = binary_op(std::move(back), unary_op(*last));
+    }
+    return binary_op(front, back);
+  }
+  template<bool Constant, typename U, typename BinaryOp, typename UnaryOp>
+  friend U transform_reduce(basic_iterator<Constant> first, basic_iterator<Constant> last, U init, BinaryOp&& binary_op,
+                            UnaryOp&& unary_op) {
+    return transform_reduce(prefetch<true>{}, first, last, std::move(init), std::forward<BinaryOp>(binary_op),
+                            std::forward<UnaryOp>(unary_op));
+  }
+
+  template<std::size_t Depth, locality Locality, bool Write, typename Target, bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(prefetch<Depth, Locality, Write, Target>, basic_iterator<Constant> first,
+                                          basic_iterator<Constant> last, UnaryPredicate&& pred) {
+    return detail::prefetching_find<Depth, Locality, Write, Target>(
+        first, last, [&](basic_iterator<Constant> it) { return bool(pred(*it)); });
+  }
+  template<bool Constant, typename UnaryPredicate>
+  friend basic_iterator<Constant> find_if(basic_iterator<Constant> first, basic_iterator<Constant> last,
+                                          UnaryPredicate&& pred) {
+    return find_if(prefetch<true>{}, first, last, std::forward<UnaryPredicate>(pred));
+  }
+};
+
+} // namespace intrusive
+
+PLEIONE_NAMESPACE_END
+
+#endif
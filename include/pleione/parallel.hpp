@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLEIONE_PARALLEL_HPP
+#define PLEIONE_PARALLEL_HPP
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core.hpp"
+
+#include "detail/parallel.hpp"
+
+PLEIONE_NAMESPACE_BEGIN
+
+/// \brief Execution policy running traversal algorithms on multiple threads
+///
+/// The range is split into contiguous segments, one per thread, and each of
+/// them is processed by the sequential version of the algorithm, so the
+/// callbacks are invoked concurrently. Finding the split points requires
+/// walking the range once, which means that this pays off only if the work
+/// done per element dominates the cost of following the links.
+///
+/// \note This header is not included by the containers, since it requires
+/// linking with the platform's thread library, e.g. `Threads::Threads`.
+struct parallel {
+  /// Number of threads, 0 means one per hardware thread
+  unsigned threads = 0;
+};
+
+/// \brief Invokes a function on each element of a list or forward_list range
+///
+/// If any invocation throws, all threads are joined and one of the exceptions
+/// is rethrown.
+template<typename Iterator, typename UnaryFunction>
+void for_each(parallel policy, Iterator first, Iterator last, UnaryFunction&& fn) {
+  detail::run_segments(detail::split_segments(policy.threads, first, last),
+                       [&](std::size_t, Iterator begin, Iterator end) { for_each(prefetch<true>{}, begin, end, fn); });
+}
+
+/// \brief Reduces a list or forward_list range
+///
+/// The segments are reduced concurrently and their results are combined in
+/// order, so `binary_op` needs to be associative, but not commutative.
+template<typename Iterator, typename U, typename BinaryOp, typename UnaryOp>
+U transform_reduce(parallel policy, Iterator first, Iterator last, U init, BinaryOp&& binary_op, UnaryOp&& unary_op) {
+  auto boundaries = detail::split_segments(policy.threads, first, last);
+  auto results = std::vector<std::optional<U>>(boundaries.size());
+  detail::run_segments(boundaries, [&](std::size_t idx, Iterator begin, Iterator end) {
+    auto value = U(unary_op(*begin++));
+    results[idx] = transform_reduce(prefetch<true>{}, begin, end, std::move(value), binary_op, unary_op);
+  });
+  for (auto& result : results) {
+    if (result) { init = binary_op(std::move(init), std::move(*result)); }
+  }
+  return init;
+}
+
+PLEIONE_NAMESPACE_END
+
+#endif
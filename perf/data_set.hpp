@@ -70,4 +70,14 @@ public:
   BENCHMARK_TEMPLATE(function, reversed)->RangeMultiplier(1000)->Range(10, 1'000'000);                                 \
   BENCHMARK_TEMPLATE(function, random)->RangeMultiplier(1000)->Range(10, 1'000'000)
 
+#define PLEIONE_DATA_SET_LARGE_PERF_TEST(function)                                                                     \
+  BENCHMARK_TEMPLATE(function, sequential)->RangeMultiplier(1000)->Range(10, 10'000'000);                              \
+  BENCHMARK_TEMPLATE(function, reversed)->RangeMultiplier(1000)->Range(10, 10'000'000);                                \
+  BENCHMARK_TEMPLATE(function, random)->RangeMultiplier(1000)->Range(10, 10'000'000)
+
+#define PLEIONE_DATA_SET_PERF_TEST_ARGS(function, ...)                                                                 \
+  BENCHMARK_TEMPLATE(function, sequential, __VA_ARGS__)->RangeMultiplier(1000)->Range(10, 1'000'000);                  \
+  BENCHMARK_TEMPLATE(function, reversed, __VA_ARGS__)->RangeMultiplier(1000)->Range(10, 1'000'000);                    \
+  BENCHMARK_TEMPLATE(function, random, __VA_ARGS__)->RangeMultiplier(1000)->Range(10, 1'000'000)
+
 #endif
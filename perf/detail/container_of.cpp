@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Cost of getting from a member to its containing object when the offset is
+// a compile-time constant and when it has to be derived from a member pointer
+// unknown to the compiler.
+
+#include "pleione/detail/container_of.hpp"
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace perf {
+
+struct member {
+  int value_ = 0;
+};
+
+struct object {
+  int value_ = 0;
+  member member_;
+};
+
+static std::vector<member*> make_members(std::vector<object>& objects) {
+  auto members = std::vector<member*>();
+  for (auto& obj : objects) { members.emplace_back(&obj.member_); }
+  return members;
+}
+
+void container_of_constant(benchmark::State& s) {
+  auto objects = std::vector<object>(size_t(s.range(0)));
+  auto members = make_members(objects);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto sum = 0;
+    for (auto m : members) { sum += pleione::detail::container_of<object, &object::member_>(*m).value_; }
+    benchmark::DoNotOptimize(sum);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * members.size(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(container_of_constant)->Arg(1000);
+
+void container_of_member_pointer(benchmark::State& s) {
+  auto objects = std::vector<object>(size_t(s.range(0)));
+  auto members = make_members(objects);
+  auto pointer = &object::member_;
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::DoNotOptimize(pointer);
+    auto sum = 0;
+    for (auto m : members) { sum += pleione::detail::container_of(pointer, *m).value_; }
+    benchmark::DoNotOptimize(sum);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * members.size(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(container_of_member_pointer)->Arg(1000);
+
+} // namespace perf
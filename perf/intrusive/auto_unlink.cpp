@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Removing an object from the three size-less lists it is linked into and
+// putting it back. Auto-unlink hooks and iterator_to() remove it in constant
+// time, while without them each list has to be searched for the object.
+
+#include "pleione/intrusive/list.hpp"
+
+#include <algorithm>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+template<typename Hook> struct object {
+  Hook a_;
+  Hook b_;
+  Hook c_;
+  int value_ = 0;
+};
+
+using plain_object = object<pleione::intrusive::list_hook>;
+using unlinking_object = object<pleione::intrusive::auto_unlink_list_hook>;
+
+template<typename Object> struct lists {
+  pleione::intrusive::list<Object, &Object::a_, false> a;
+  pleione::intrusive::list<Object, &Object::b_, false> b;
+  pleione::intrusive::list<Object, &Object::c_, false> c;
+
+  explicit lists(std::vector<Object*> const& pointers) {
+    for (auto p : pointers) {
+      a.push_back(*p);
+      b.push_front(*p);
+      c.push_back(*p);
+    }
+  }
+
+  void push(Object& obj) noexcept {
+    a.push_back(obj);
+    b.push_front(obj);
+    c.push_back(obj);
+  }
+};
+
+class random_indices {
+  std::vector<size_t> indices_;
+  size_t next_ = 0;
+
+public:
+  explicit random_indices(size_t n) : indices_(1 << 16) {
+    auto eng = std::default_random_engine(0);
+    auto dist = std::uniform_int_distribution<size_t>(0, n - 1);
+    std::generate(indices_.begin(), indices_.end(), [&] { return dist(eng); });
+  }
+
+  size_t operator()() noexcept { return indices_[next_++ & (indices_.size() - 1)]; }
+};
+
+template<template<typename> typename T> void auto_unlink(benchmark::State& s) {
+  auto [objects, pointers] = T<unlinking_object>{}(size_t(s.range(0)));
+  auto l = lists<unlinking_object>(pointers);
+  auto indices = random_indices(objects.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto& obj = objects[indices()];
+    obj.a_.unlink();
+    obj.b_.unlink();
+    obj.c_.unlink();
+    l.push(obj);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+  l.a.clear();
+  l.b.clear();
+  l.c.clear();
+}
+
+PLEIONE_DATA_SET_PERF_TEST(auto_unlink);
+
+template<template<typename> typename T> void iterator_to_erase(benchmark::State& s) {
+  auto [objects, pointers] = T<plain_object>{}(size_t(s.range(0)));
+  auto l = lists<plain_object>(pointers);
+  auto indices = random_indices(objects.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto& obj = objects[indices()];
+    l.a.erase(l.a.iterator_to(obj));
+    l.b.erase(l.b.iterator_to(obj));
+    l.c.erase(l.c.iterator_to(obj));
+    l.push(obj);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(iterator_to_erase);
+
+template<template<typename> typename T> void find_erase(benchmark::State& s) {
+  auto [objects, pointers] = T<plain_object>{}(size_t(s.range(0)));
+  auto l = lists<plain_object>(pointers);
+  auto indices = random_indices(objects.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto& obj = objects[indices()];
+    auto is_obj = [&](plain_object const& other) { return &other == &obj; };
+    l.a.erase(find_if(l.a.begin(), l.a.end(), is_obj));
+    l.b.erase(find_if(l.b.begin(), l.b.end(), is_obj));
+    l.c.erase(find_if(l.c.begin(), l.c.end(), is_obj));
+    l.push(obj);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+}
+
+// Each removal walks the lists, so the large data sets would take too long.
+BENCHMARK_TEMPLATE(find_erase, sequential)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(find_erase, reversed)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(find_erase, random)->RangeMultiplier(10)->Range(10, 1000);
+
+} // namespace perf
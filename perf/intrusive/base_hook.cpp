@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Traversal of lists linked through member hooks and through base class hooks.
+// Both objects have the same layout, with the hook used by the list placed
+// after another hook, so that converting it to the element is not a no-op.
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <functional>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct by_other;
+struct by_perf;
+
+struct member_object {
+  pleione::intrusive::list_hook other_;
+  pleione::intrusive::list_hook hook_;
+  pleione::intrusive::forward_list_hook forward_hook_;
+  int value_ = 0;
+};
+
+struct base_object : pleione::intrusive::list_base_hook<by_other>,
+                     pleione::intrusive::list_base_hook<by_perf>,
+                     pleione::intrusive::forward_list_base_hook<by_perf> {
+  int value_ = 0;
+};
+
+using member_list = pleione::intrusive::list<member_object, &member_object::hook_>;
+using base_list = pleione::intrusive::list<base_object, pleione::intrusive::base_hook<by_perf>>;
+using member_forward_list = pleione::intrusive::forward_list<member_object, &member_object::forward_hook_>;
+using base_forward_list = pleione::intrusive::forward_list<base_object, pleione::intrusive::base_hook<by_perf>>;
+
+template<typename List> static List make_list(std::vector<typename List::value_type*> const& pointers) {
+  auto list = List();
+  for (auto it = pointers.rbegin(); it != pointers.rend(); ++it) { list.push_front(**it); }
+  return list;
+}
+
+template<typename List, template<typename> typename T> static void iterate(benchmark::State& s) {
+  auto [objects, pointers] = T<typename List::value_type>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list<List>(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for (auto& obj : list) { benchmark::DoNotOptimize(obj.value_); }
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+template<typename List, template<typename> typename T> static void sum(benchmark::State& s) {
+  using value_type = typename List::value_type;
+  auto [objects, pointers] = T<value_type>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list<List>(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = transform_reduce(pleione::prefetch<true>{}, list.begin(), list.end(), 0, std::plus<>{},
+                                [](value_type const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+template<template<typename> typename T> void member_list_iterate(benchmark::State& s) {
+  iterate<member_list, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(member_list_iterate);
+
+template<template<typename> typename T> void base_list_iterate(benchmark::State& s) {
+  iterate<base_list, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(base_list_iterate);
+
+template<template<typename> typename T> void member_list_sum(benchmark::State& s) {
+  sum<member_list, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(member_list_sum);
+
+template<template<typename> typename T> void base_list_sum(benchmark::State& s) {
+  sum<base_list, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(base_list_sum);
+
+template<template<typename> typename T> void member_forward_list_sum(benchmark::State& s) {
+  sum<member_forward_list, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(member_forward_list_sum);
+
+template<template<typename> typename T> void base_forward_list_sum(benchmark::State& s) {
+  sum<base_forward_list, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(base_forward_list_sum);
+
+} // namespace perf
@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Traversal of lists with pointer hooks, compact hooks storing 32-bit offsets
+// and offset hooks storing self-relative offsets. In all cases the list header
+// and the elements are allocated in a single arena, the elements are linked in
+// the order given by the data set.
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <functional>
+#include <memory>
+#include <new>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct perf_arena {
+  static inline std::byte* base_ = nullptr;
+  static std::byte* base() noexcept { return base_; }
+};
+
+template<typename Hook> struct object {
+  Hook hook_;
+  int value_ = 0;
+};
+
+using list_object = object<pleione::intrusive::list_hook>;
+using compact_list_object = object<pleione::intrusive::compact_list_hook<perf_arena>>;
+using forward_list_object = object<pleione::intrusive::forward_list_hook>;
+using compact_forward_list_object = object<pleione::intrusive::compact_forward_list_hook<perf_arena>>;
+using offset_list_object = object<pleione::intrusive::offset_list_hook>;
+using offset_forward_list_object = object<pleione::intrusive::offset_forward_list_hook>;
+
+template<typename List> class arena {
+  using value_type = typename List::value_type;
+
+  static constexpr size_t header_offset = alignof(std::max_align_t);
+  static constexpr size_t objects_offset = header_offset + (sizeof(List) + 63) / 64 * 64;
+
+  std::unique_ptr<std::byte[]> storage_;
+  List* list_;
+  value_type* objects_;
+  size_t size_;
+
+public:
+  template<template<typename> typename T> explicit arena(T<value_type> data_set, size_t n)
+      : storage_(new std::byte[objects_offset + n * sizeof(value_type)]), size_(n) {
+    perf_arena::base_ = storage_.get();
+    list_ = new (storage_.get() + header_offset) List();
+    objects_ = new (storage_.get() + objects_offset) value_type[n];
+    auto [objects, pointers] = data_set(n);
+    for (auto p : pointers) { list_->push_front(objects_[p - objects.data()]); }
+  }
+  ~arena() {
+    list_->~List();
+    std::destroy_n(objects_, size_);
+  }
+
+  List& list() noexcept { return *list_; }
+};
+
+template<typename List, template<typename> typename T> void for_each(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  auto data = arena<List>(T<typename List::value_type>{}, n);
+  auto& list = data.list();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(list.begin(), list.end(), [](auto& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * n, benchmark::Counter::kIsRate);
+}
+
+template<typename List, template<typename> typename T> void transform_reduce(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  auto data = arena<List>(T<typename List::value_type>{}, n);
+  auto& list = data.list();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = transform_reduce(list.begin(), list.end(), 0, std::plus<>{}, [](auto& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * n, benchmark::Counter::kIsRate);
+}
+
+template<template<typename> typename T> void list_for_each(benchmark::State& s) {
+  for_each<pleione::intrusive::list<list_object, &list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(list_for_each);
+
+template<template<typename> typename T> void compact_list_for_each(benchmark::State& s) {
+  for_each<pleione::intrusive::list<compact_list_object, &compact_list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(compact_list_for_each);
+
+template<template<typename> typename T> void offset_list_for_each(benchmark::State& s) {
+  for_each<pleione::intrusive::list<offset_list_object, &offset_list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(offset_list_for_each);
+
+template<template<typename> typename T> void list_transform_reduce(benchmark::State& s) {
+  transform_reduce<pleione::intrusive::list<list_object, &list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(list_transform_reduce);
+
+template<template<typename> typename T> void compact_list_transform_reduce(benchmark::State& s) {
+  transform_reduce<pleione::intrusive::list<compact_list_object, &compact_list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(compact_list_transform_reduce);
+
+template<template<typename> typename T> void forward_list_for_each(benchmark::State& s) {
+  for_each<pleione::intrusive::forward_list<forward_list_object, &forward_list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(forward_list_for_each);
+
+template<template<typename> typename T> void compact_forward_list_for_each(benchmark::State& s) {
+  for_each<pleione::intrusive::forward_list<compact_forward_list_object, &compact_forward_list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(compact_forward_list_for_each);
+
+template<template<typename> typename T> void offset_forward_list_for_each(benchmark::State& s) {
+  for_each<pleione::intrusive::forward_list<offset_forward_list_object, &offset_forward_list_object::hook_>, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(offset_forward_list_for_each);
+
+} // namespace perf
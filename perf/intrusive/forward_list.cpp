@@ -0,0 +1,296 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+
+#include <functional>
+#include <numeric>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::forward_list_hook hook_;
+  int value_ = 0;
+};
+
+using list_type = pleione::intrusive::forward_list<object, &object::hook_>;
+
+static list_type make_list(std::vector<object*> const& pointers) {
+  auto list = list_type();
+  for (auto it = pointers.rbegin(); it != pointers.rend(); ++it) { list.push_front(**it); }
+  return list;
+}
+
+template<template<typename> typename T> void for_each(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(pleione::prefetch<true>{}, list.begin(), list.end(),
+             [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each);
+
+template<template<typename> typename T> void for_each_no_prefetch(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(pleione::prefetch<false>{}, list.begin(), list.end(),
+             [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each_no_prefetch);
+
+template<template<typename> typename T> void std_any_of(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = std::any_of(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(std_any_of);
+
+template<template<typename> typename T> void any_of(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = any_of(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(any_of);
+
+template<template<typename> typename T> void std_count_if(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = std::count_if(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(std_count_if);
+
+template<template<typename> typename T> void count_if(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = count_if(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(count_if);
+
+template<template<typename> typename T> void std_transform_reduce(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = std::transform_reduce(list.begin(), list.end(), 0, std::plus<>{},
+                                     [](object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(std_transform_reduce);
+
+template<template<typename> typename T> void transform_reduce(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret =
+        transform_reduce(list.begin(), list.end(), 0, std::plus<>{}, [](object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(transform_reduce);
+
+template<template<typename> typename T> void push_pop_front(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list(pointers);
+  auto popped = std::vector<object*>(pointers.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for (auto& p : popped) {
+      p = &list.front();
+      list.pop_front();
+    }
+    for (auto it = popped.rbegin(); it != popped.rend(); ++it) { list.push_front(**it); }
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size() * 2, benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(push_pop_front);
+
+template<template<typename> typename T> void insert_after_range(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto refs = std::vector<std::reference_wrapper<object>>();
+  for (auto p : pointers) { refs.emplace_back(*p); }
+  auto list = list_type();
+
+  static constexpr size_t chunk_size = 64;
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    list.clear();
+    auto position = list.before_begin();
+    for (auto first = refs.begin(); first != refs.end();) {
+      auto last = first + std::min(chunk_size, size_t(refs.end() - first));
+      position = list.insert_after(position, first, last);
+      first = last;
+    }
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(insert_after_range);
+
+template<template<typename> typename T> void splice_after(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto a = make_list(pointers);
+  auto anchors = std::vector<object>(2);
+  auto b = list_type(anchors.begin(), anchors.end());
+  auto second_anchor = std::next(b.begin());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    b.splice_after(b.begin(), a);
+    a.splice_after(a.before_begin(), b, b.begin(), second_anchor);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * 2, benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(splice_after);
+
+// A consumer queue holding the whole data set receives batches at its tail:
+// each iteration takes a batch from the front of the queue and hands it back
+// by splicing it after the last element.
+static constexpr size_t batch_size = 16;
+
+template<template<typename> typename T> void queue_handoff(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto queue = make_list(pointers);
+  auto batch = list_type();
+  auto n = pointers.size();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto count = std::min(batch_size, n);
+    batch.splice_after(batch.before_begin(), queue, queue.before_begin(), std::next(queue.begin(), count));
+    queue.splice_after(std::next(queue.before_begin(), n - count), batch);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(queue_handoff);
+
+template<template<typename> typename T> void tail_tracking_queue_handoff(benchmark::State& s) {
+  using tracked_list_type = pleione::intrusive::forward_list<object, &object::hook_, true>;
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto queue = tracked_list_type();
+  for (auto p : pointers) { queue.push_back(*p); }
+  auto batch = tracked_list_type();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto count = std::min(batch_size, queue.size());
+    batch.splice_after(batch.before_begin(), queue, queue.before_begin(), std::next(queue.begin(), count));
+    queue.splice_after(queue.last(), batch);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(tail_tracking_queue_handoff);
+
+} // namespace perf
@@ -0,0 +1,138 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Hash tables made of arrays of hlist, list and forward_list heads, with one
+// or eight elements per bucket. The heads are 8, 24 and 8 bytes long respectively,
+// so the arrays of hlist and forward_list heads take up less cache and memory.
+// Lookups walk the bucket of a random key, churn erases a random element from
+// its bucket and inserts it back, which needs to find the preceding element
+// in a forward_list.
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/hlist.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace perf {
+
+template<typename Hook> struct object {
+  Hook hook_;
+  std::uint64_t key_ = 0;
+};
+
+using hlist_object = object<pleione::intrusive::hlist_hook>;
+using list_object = object<pleione::intrusive::list_hook>;
+using forward_list_object = object<pleione::intrusive::forward_list_hook>;
+
+using hlist_type = pleione::intrusive::hlist<hlist_object, &hlist_object::hook_>;
+using list_type = pleione::intrusive::list<list_object, &list_object::hook_>;
+using forward_list_type = pleione::intrusive::forward_list<forward_list_object, &forward_list_object::hook_>;
+
+static void erase(hlist_type& bucket, hlist_object& obj) noexcept { bucket.erase(obj); }
+static void erase(list_type& bucket, list_object& obj) noexcept { bucket.erase(obj); }
+static void erase(forward_list_type& bucket, forward_list_object& obj) noexcept {
+  bucket.erase_after(bucket.previous(bucket.iterator_to(obj)));
+}
+
+template<typename List> class table {
+  using value_type = typename List::value_type;
+
+  std::vector<value_type> objects_;
+  std::vector<List> buckets_;
+  unsigned shift_;
+
+public:
+  // The number of buckets has to be a power of two.
+  table(size_t buckets, size_t load)
+      : objects_(buckets * load), buckets_(buckets), shift_(64 - __builtin_ctzll(buckets)) {
+    for (auto i = size_t(0); i < objects_.size(); ++i) {
+      objects_[i].key_ = i;
+      bucket(i).push_front(objects_[i]);
+    }
+  }
+
+  List& bucket(std::uint64_t key) noexcept { return buckets_[(key * 0x9e3779b97f4a7c15ull) >> shift_]; }
+
+  value_type* find(std::uint64_t key) noexcept {
+    auto& b = bucket(key);
+    auto it = find_if(pleione::prefetch<false>{}, b.begin(), b.end(),
+                      [&](value_type const& obj) { return obj.key_ == key; });
+    return it == b.end() ? nullptr : &*it;
+  }
+
+  void churn(std::uint64_t key) noexcept {
+    auto& obj = objects_[key];
+    auto& b = bucket(key);
+    erase(b, obj);
+    b.push_front(obj);
+  }
+
+  size_t head_bytes() const noexcept { return buckets_.size() * sizeof(List); }
+};
+
+static std::vector<std::uint64_t> random_keys(size_t n) {
+  auto keys = std::vector<std::uint64_t>(1 << 16);
+  auto eng = std::default_random_engine(0);
+  auto dist = std::uniform_int_distribution<std::uint64_t>(0, n - 1);
+  std::generate(keys.begin(), keys.end(), [&] { return dist(eng); });
+  return keys;
+}
+
+template<typename List> void lookup(benchmark::State& s) {
+  auto n = size_t(s.range(0)) * size_t(s.range(1));
+  auto t = table<List>(size_t(s.range(0)), size_t(s.range(1)));
+  auto keys = random_keys(n);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::DoNotOptimize(t.find(keys[iterations++ & (keys.size() - 1)]));
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+  s.counters["head_bytes"] = double(t.head_bytes());
+}
+
+BENCHMARK_TEMPLATE(lookup, hlist_type)->RangeMultiplier(32)->Ranges({{1 << 10, 1 << 20}, {1, 8}});
+BENCHMARK_TEMPLATE(lookup, list_type)->RangeMultiplier(32)->Ranges({{1 << 10, 1 << 20}, {1, 8}});
+BENCHMARK_TEMPLATE(lookup, forward_list_type)->RangeMultiplier(32)->Ranges({{1 << 10, 1 << 20}, {1, 8}});
+
+template<typename List> void churn(benchmark::State& s) {
+  auto n = size_t(s.range(0)) * size_t(s.range(1));
+  auto t = table<List>(size_t(s.range(0)), size_t(s.range(1)));
+  auto keys = random_keys(n);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) { t.churn(keys[iterations++ & (keys.size() - 1)]); }
+  s.counters["ops"] = benchmark::Counter(double(iterations), benchmark::Counter::kIsRate);
+  s.counters["head_bytes"] = double(t.head_bytes());
+}
+
+BENCHMARK_TEMPLATE(churn, hlist_type)->RangeMultiplier(32)->Ranges({{1 << 10, 1 << 20}, {1, 8}});
+BENCHMARK_TEMPLATE(churn, list_type)->RangeMultiplier(32)->Ranges({{1 << 10, 1 << 20}, {1, 8}});
+BENCHMARK_TEMPLATE(churn, forward_list_type)->RangeMultiplier(32)->Ranges({{1 << 10, 1 << 20}, {1, 8}});
+
+} // namespace perf
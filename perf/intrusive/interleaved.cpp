@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Many short lists, e.g. the buckets of a hash table or per-tenant queues,
+// are walked one after another or in an interleaved batch.
+
+#include "pleione/intrusive/interleaved.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <functional>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::list_hook hook_;
+  int value_ = 0;
+};
+
+using list_type = pleione::intrusive::list<object, &object::hook_>;
+
+static std::vector<list_type> make_lists(std::vector<object*> const& pointers, size_t length) {
+  auto lists = std::vector<list_type>((pointers.size() + length - 1) / length);
+  for (auto idx = 0u; idx < pointers.size(); idx++) { lists[idx / length].push_back(*pointers[idx]); }
+  return lists;
+}
+
+static void list_lengths(benchmark::internal::Benchmark* b) {
+  for (auto length : {4, 16, 64}) { b->Args({1'000'000, length}); }
+}
+
+#define PLEIONE_BATCH_PERF_TEST(function, ...)                                                                         \
+  BENCHMARK_TEMPLATE(function, sequential, ##__VA_ARGS__)->Apply(list_lengths);                                        \
+  BENCHMARK_TEMPLATE(function, random, ##__VA_ARGS__)->Apply(list_lengths)
+
+template<template<typename> typename T> void transform_reduce(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto lists = make_lists(pointers, size_t(s.range(1)));
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = 0;
+    for (auto& list : lists) {
+      ret = transform_reduce(list.begin(), list.end(), ret, std::plus<>{}, [](object const& obj) { return obj.value_; });
+    }
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_BATCH_PERF_TEST(transform_reduce);
+
+template<template<typename> typename T, size_t Width> void transform_reduce_interleaved(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto lists = make_lists(pointers, size_t(s.range(1)));
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = pleione::intrusive::transform_reduce_interleaved<Width>(lists.begin(), lists.end(), 0, std::plus<>{},
+                                                                       [](object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_BATCH_PERF_TEST(transform_reduce_interleaved, 4);
+PLEIONE_BATCH_PERF_TEST(transform_reduce_interleaved, 8);
+PLEIONE_BATCH_PERF_TEST(transform_reduce_interleaved, 16);
+
+template<template<typename> typename T> void for_each(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto lists = make_lists(pointers, size_t(s.range(1)));
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for (auto& list : lists) {
+      for_each(list.begin(), list.end(), [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    }
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_BATCH_PERF_TEST(for_each);
+
+template<template<typename> typename T, size_t Width> void for_each_interleaved(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto lists = make_lists(pointers, size_t(s.range(1)));
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    pleione::intrusive::for_each_interleaved<Width>(lists.begin(), lists.end(),
+                                                    [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_BATCH_PERF_TEST(for_each_interleaved, 8);
+
+} // namespace perf
@@ -21,7 +21,11 @@
  * SOFTWARE.
  */
 
+#include "pleione/intrusive/lazy_checkpoint_index.hpp"
 #include "pleione/intrusive/list.hpp"
+#include "pleione/parallel.hpp"
+
+#include <thread>
 
 #include "../data_set.hpp"
 
@@ -89,6 +93,60 @@ template<template<typename> typename T> void std_any_of(benchmark::State& s) {
 
 PLEIONE_DATA_SET_PERF_TEST(std_any_of);
 
+template<template<typename> typename T> void any_of(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = any_of(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(any_of);
+
+template<template<typename> typename T> void std_count_if(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = std::count_if(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(std_count_if);
+
+template<template<typename> typename T> void count_if(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = count_if(list.begin(), list.end(), [](object const& obj) { return obj.value_ == 1; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(count_if);
+
 template<template<typename> typename T> void transform_reduce(benchmark::State& s) {
   auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
   (void)objects;
@@ -108,4 +166,213 @@ template<template<typename> typename T> void transform_reduce(benchmark::State&
 
 PLEIONE_DATA_SET_PERF_TEST(transform_reduce);
 
+#define PLEIONE_PREFETCH_DEPTH_PERF_TEST(function)                                                                     \
+  PLEIONE_DATA_SET_PERF_TEST_ARGS(function, 0);                                                                        \
+  PLEIONE_DATA_SET_PERF_TEST_ARGS(function, 1);                                                                        \
+  PLEIONE_DATA_SET_PERF_TEST_ARGS(function, 2);                                                                        \
+  PLEIONE_DATA_SET_PERF_TEST_ARGS(function, 4);                                                                        \
+  PLEIONE_DATA_SET_PERF_TEST_ARGS(function, 8);                                                                        \
+  PLEIONE_DATA_SET_PERF_TEST_ARGS(function, 16)
+
+template<template<typename> typename T, size_t Depth> void for_each_depth(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(pleione::prefetch<Depth>{}, list.begin(), list.end(),
+             [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_PREFETCH_DEPTH_PERF_TEST(for_each_depth);
+
+template<template<typename> typename T, size_t Depth> void for_each_depth_nta(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(pleione::prefetch<Depth, pleione::locality::nta>{}, list.begin(), list.end(),
+             [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_PREFETCH_DEPTH_PERF_TEST(for_each_depth_nta);
+
+template<template<typename> typename T, size_t Depth> void transform_reduce_depth(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = transform_reduce(pleione::prefetch<Depth>{}, list.begin(), list.end(), 0, std::plus<>{},
+                                [](object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_PREFETCH_DEPTH_PERF_TEST(transform_reduce_depth);
+
+// The visited field is far enough from the hook to be in a different cache
+// line, so prefetching just the hooks leaves a miss per element.
+struct wide_object {
+  pleione::intrusive::list_hook hook_;
+  char padding_[256];
+  int value_ = 0;
+};
+
+template<typename Prefetch, template<typename> typename T> void for_each_payload(benchmark::State& s) {
+  auto [objects, pointers] = T<wide_object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<wide_object, &wide_object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(Prefetch{}, list.begin(), list.end(), [](wide_object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+template<template<typename> typename T> void for_each_payload_hook(benchmark::State& s) {
+  for_each_payload<pleione::prefetch<4>, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each_payload_hook);
+
+template<template<typename> typename T> void for_each_payload_members(benchmark::State& s) {
+  for_each_payload<pleione::prefetch<4>::members<&wide_object::value_>, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each_payload_members);
+
+template<template<typename> typename T> void for_each_payload_object(benchmark::State& s) {
+  for_each_payload<pleione::prefetch<4>::object, T>(s);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each_payload_object);
+
+static void thread_counts(benchmark::internal::Benchmark* b) {
+  auto max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (auto threads = 1u; threads < max_threads * 2; threads *= 2) {
+    b->Args({1'000'000, std::min<int>(threads, max_threads)});
+  }
+  b->UseRealTime();
+}
+
+#define PLEIONE_THREAD_COUNT_PERF_TEST(function)                                                                       \
+  BENCHMARK_TEMPLATE(function, sequential)->Apply(thread_counts);                                                      \
+  BENCHMARK_TEMPLATE(function, random)->Apply(thread_counts)
+
+// Simulates a callback doing some computation on each element, enough to
+// dominate the cost of following the links.
+static int compute(int value) noexcept {
+  for (auto i = 0; i < 64; i++) {
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    benchmark::DoNotOptimize(value);
+  }
+  return value;
+}
+
+template<template<typename> typename T> void for_each_parallel(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+  auto policy = pleione::parallel{unsigned(s.range(1))};
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(policy, list.begin(), list.end(), [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_THREAD_COUNT_PERF_TEST(for_each_parallel);
+
+template<template<typename> typename T> void for_each_parallel_compute(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+  auto policy = pleione::parallel{unsigned(s.range(1))};
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(policy, list.begin(), list.end(), [](object& obj) { obj.value_ = compute(obj.value_ + 1); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_THREAD_COUNT_PERF_TEST(for_each_parallel_compute);
+
+template<template<typename> typename T> void transform_reduce_parallel_compute(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+  for (auto p : pointers) { list.push_back(*p); }
+  auto policy = pleione::parallel{unsigned(s.range(1))};
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = transform_reduce(policy, list.begin(), list.end(), 0, std::plus<>{},
+                                [](object const& obj) { return compute(obj.value_ + 1); });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_THREAD_COUNT_PERF_TEST(transform_reduce_parallel_compute);
+
+template<template<typename> typename T, size_t Cursors> void transform_reduce_cursors(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_, true, true>();
+  for (auto p : pointers) { list.push_back(*p); }
+  auto index = pleione::intrusive::lazy_checkpoint_index(list);
+  index.update();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = pleione::intrusive::transform_reduce<Cursors>(index, 0, std::plus<>{},
+                                                             [](object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST_ARGS(transform_reduce_cursors, 1);
+PLEIONE_DATA_SET_PERF_TEST_ARGS(transform_reduce_cursors, 2);
+PLEIONE_DATA_SET_PERF_TEST_ARGS(transform_reduce_cursors, 4);
+PLEIONE_DATA_SET_PERF_TEST_ARGS(transform_reduce_cursors, 8);
+PLEIONE_DATA_SET_PERF_TEST_ARGS(transform_reduce_cursors, 16);
+
 } // namespace perf
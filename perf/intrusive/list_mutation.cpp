@@ -0,0 +1,263 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Each benchmark iteration performs a single mutation (or a mutation and its
+// inverse, so that the list stays in a steady state), which makes the reported
+// time per iteration the cost of one operation.
+
+#include "pleione/intrusive/list.hpp"
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::list_hook hook_;
+  int value_ = 0;
+};
+
+using list_type = pleione::intrusive::list<object, &object::hook_>;
+
+static constexpr size_t range_size = 16;
+
+class random_indices {
+  std::vector<size_t> indices_;
+  size_t next_ = 0;
+
+public:
+  explicit random_indices(size_t n) : indices_(1 << 16) {
+    auto eng = std::default_random_engine(0);
+    auto dist = std::uniform_int_distribution<size_t>(0, n - 1);
+    std::generate(indices_.begin(), indices_.end(), [&] { return dist(eng); });
+  }
+
+  size_t operator()() noexcept { return indices_[next_++ & (indices_.size() - 1)]; }
+};
+
+static std::vector<list_type::iterator> make_list(list_type& list, std::vector<object*> const& pointers) {
+  auto iterators = std::vector<list_type::iterator>();
+  iterators.reserve(pointers.size());
+  for (auto p : pointers) {
+    list.push_back(*p);
+    iterators.emplace_back(std::prev(list.end()));
+  }
+  return iterators;
+}
+
+static void report_ops(benchmark::State& s, uint64_t ops) {
+  s.counters["ops"] = benchmark::Counter(double(ops), benchmark::Counter::kIsRate);
+}
+
+template<template<typename> typename T> void push_back_pop_front(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  make_list(list, pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto& obj = list.front();
+    list.pop_front();
+    list.push_back(obj);
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(push_back_pop_front);
+
+template<template<typename> typename T> void push_front_pop_back(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  make_list(list, pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto& obj = list.back();
+    list.pop_back();
+    list.push_front(obj);
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(push_front_pop_back);
+
+template<template<typename> typename T> void erase_insert_random(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  auto iterators = make_list(list, pointers);
+  auto indices = random_indices(pointers.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto idx = indices();
+    auto& obj = *iterators[idx];
+    auto position = list.erase(iterators[idx]);
+    iterators[idx] = list.insert(position == list.end() ? list.begin() : std::next(position), obj);
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(erase_insert_random);
+
+template<template<typename> typename T> void churn(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  auto iterators = make_list(list, pointers);
+  auto indices = random_indices(pointers.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto idx = indices();
+    auto& obj = *iterators[idx];
+    list.erase(iterators[idx]);
+    list.push_back(obj);
+    iterators[idx] = std::prev(list.end());
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(churn);
+
+template<template<typename> typename T> void insert_erase_range(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  auto iterators = make_list(list, pointers);
+  auto indices = random_indices(pointers.size());
+  auto extra = std::vector<object>(range_size);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto position = iterators[indices()];
+    auto first = list.insert(position, extra.begin(), extra.end());
+    list.erase(first, position);
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(insert_erase_range);
+
+template<template<typename> typename T> void splice_element(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  auto iterators = make_list(list, pointers);
+  auto indices = random_indices(pointers.size());
+  auto other = list_type();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto idx = indices();
+    auto position = std::next(iterators[idx]);
+    other.splice(other.end(), list, iterators[idx]);
+    list.splice(position, other, iterators[idx]);
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(splice_element);
+
+template<template<typename> typename T> void splice_range(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  auto iterators = make_list(list, pointers);
+  auto indices = random_indices(std::max(pointers.size(), range_size + 1) - range_size);
+  auto other = list_type();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto first = iterators[indices()];
+    auto last = first;
+    for (auto i = 0u; i < range_size && last != list.end(); ++i) { ++last; }
+    other.splice(other.end(), list, first, last);
+    list.splice(last, other, other.begin(), other.end());
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(splice_range);
+
+template<template<typename> typename T> void splice_all(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  make_list(list, pointers);
+  auto other = list_type();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    other.splice(other.end(), list);
+    list.splice(list.end(), other);
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(splice_all);
+
+// Moves the second half of the list to another one and back. With the size
+// tracked both range splices have to count the elements they move.
+template<typename List> static void splice_half(benchmark::State& s, std::vector<object*> const& pointers) {
+  auto list = List();
+  for (auto p : pointers) { list.push_back(*p); }
+  auto middle = std::next(list.begin(), pointers.size() / 2);
+  auto other = List();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    other.splice(other.end(), list, middle, list.end());
+    list.splice(list.end(), other, other.begin(), other.end());
+    ++iterations;
+  }
+  report_ops(s, iterations * 2);
+}
+
+template<template<typename> typename T> void splice_half(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  splice_half<list_type>(s, pointers);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(splice_half);
+
+template<template<typename> typename T> void sizeless_splice_half(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  splice_half<pleione::intrusive::list<object, &object::hook_, false>>(s, pointers);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(sizeless_splice_half);
+
+} // namespace perf
@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Looks up a batch of keys in the chains of a hash table. This file is also
+// built with the AVX2 and AVX-512 implementations enabled.
+
+#include "pleione/intrusive/lockstep.hpp"
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::forward_list_hook hook_;
+  std::uint64_t key_ = 0;
+};
+
+using list_type = pleione::intrusive::forward_list<object, &object::hook_>;
+
+// Every chain has the same length and the looked up key is the one of its
+// last element, so each lookup walks the whole chain.
+static std::vector<list_type> make_chains(std::vector<object*> const& pointers, size_t length,
+                                          std::vector<std::uint64_t>& keys) {
+  auto chains = std::vector<list_type>(pointers.size() / length);
+  keys.resize(chains.size());
+  for (auto idx = 0u; idx < chains.size() * length; idx++) {
+    pointers[idx]->key_ = idx;
+    chains[idx / length].push_front(*pointers[idx]);
+  }
+  for (auto idx = 0u; idx < chains.size(); idx++) { keys[idx] = idx * length; }
+  return chains;
+}
+
+static void chain_lengths(benchmark::internal::Benchmark* b) {
+  for (auto length : {2, 8, 32}) { b->Args({1'000'000, length}); }
+}
+
+#define PLEIONE_CHAIN_PERF_TEST(function)                                                                              \
+  BENCHMARK_TEMPLATE(function, sequential)->Apply(chain_lengths);                                                      \
+  BENCHMARK_TEMPLATE(function, random)->Apply(chain_lengths)
+
+template<template<typename> typename T> void find_scalar(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto keys = std::vector<std::uint64_t>();
+  auto chains = make_chains(pointers, size_t(s.range(1)), keys);
+  auto results = std::vector<object*>(chains.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for (auto idx = 0u; idx < chains.size(); idx++) {
+      auto it = std::find_if(chains[idx].begin(), chains[idx].end(),
+                             [key = keys[idx]](object const& obj) { return obj.key_ == key; });
+      results[idx] = it == chains[idx].end() ? nullptr : &*it;
+    }
+    benchmark::DoNotOptimize(results.data());
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * chains.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_CHAIN_PERF_TEST(find_scalar);
+
+template<template<typename> typename T> void find_lockstep(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto keys = std::vector<std::uint64_t>();
+  auto chains = make_chains(pointers, size_t(s.range(1)), keys);
+  auto results = std::vector<object*>(chains.size());
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    pleione::intrusive::find_lockstep<&object::key_>(chains.begin(), chains.end(), keys.begin(), results.begin());
+    benchmark::DoNotOptimize(results.data());
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * chains.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_CHAIN_PERF_TEST(find_lockstep);
+
+} // namespace perf
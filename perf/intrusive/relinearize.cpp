@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/list.hpp"
+
+#include <memory>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::list_hook hook_;
+  int value_ = 0;
+
+  object() = default;
+  object(object&& other) noexcept : value_(other.value_) {}
+};
+
+using list_type = pleione::intrusive::list<object, &object::hook_>;
+using storage_type = std::aligned_storage_t<sizeof(object), alignof(object)>;
+
+template<template<typename> typename T> void for_each(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(list.begin(), list.end(), [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each);
+
+template<template<typename> typename T> void for_each_relinearized(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  for (auto p : pointers) { list.push_back(*p); }
+  auto arena = std::make_unique<storage_type[]>(pointers.size());
+  auto first = reinterpret_cast<object*>(arena.get());
+  auto last = list.relinearize(first);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(list.begin(), list.end(), [](object& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+
+  list.clear();
+  std::for_each(first, last, [](object& obj) { obj.~object(); });
+}
+
+PLEIONE_DATA_SET_PERF_TEST(for_each_relinearized);
+
+// Each iteration links the objects in the order given by the data set and
+// then compacts them into the other of two arenas, so the time includes only
+// the relocation of a list whose layout matches the data set.
+template<template<typename> typename T> void relinearize(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  auto order = std::vector<size_t>();
+  for (auto p : pointers) { order.emplace_back(p - objects.data()); }
+  auto n = pointers.size();
+  auto source = std::make_unique<storage_type[]>(n);
+  auto destination = std::make_unique<storage_type[]>(n);
+  for (auto i = 0u; i < n; i++) { ::new (static_cast<void*>(&source[i])) object(); }
+  auto list = list_type();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    s.PauseTiming();
+    list.clear();
+    auto src = reinterpret_cast<object*>(source.get());
+    for (auto idx : order) { list.push_back(src[idx]); }
+    s.ResumeTiming();
+    list.relinearize(reinterpret_cast<object*>(destination.get()));
+    benchmark::ClobberMemory();
+    std::swap(source, destination);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * n, benchmark::Counter::kIsRate);
+
+  list.clear();
+  auto src = reinterpret_cast<object*>(source.get());
+  std::for_each(src, src + n, [](object& obj) { obj.~object(); });
+}
+
+PLEIONE_DATA_SET_PERF_TEST(relinearize);
+
+} // namespace perf
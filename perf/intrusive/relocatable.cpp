@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Lists of elements kept in a growing std::vector, linked through relocatable
+// hooks, compared with lists of individually allocated elements. The elements
+// are linked in the order they are created, and each benchmark either builds
+// the list from scratch or walks it.
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace perf {
+
+struct object {
+  pleione::intrusive::list_hook hook_;
+  pleione::intrusive::forward_list_hook forward_hook_;
+  int value_ = 0;
+};
+
+struct relocatable_object {
+  pleione::intrusive::relocatable_list_hook hook_;
+  pleione::intrusive::relocatable_forward_list_hook forward_hook_;
+  int value_ = 0;
+};
+
+using list_type = pleione::intrusive::list<object, &object::hook_>;
+using relocatable_list_type = pleione::intrusive::list<relocatable_object, &relocatable_object::hook_>;
+using relocatable_forward_list_type =
+    pleione::intrusive::forward_list<relocatable_object, &relocatable_object::forward_hook_, true>;
+
+static void allocated_list_build(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  for (auto _ : s) {
+    auto objects = std::vector<std::unique_ptr<object>>();
+    auto list = list_type();
+    for (auto i = size_t(0); i < n; ++i) {
+      objects.emplace_back(std::make_unique<object>());
+      list.push_back(*objects.back());
+    }
+    benchmark::DoNotOptimize(list.back());
+  }
+  s.counters["ops"] = benchmark::Counter(double(s.iterations()) * n, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(allocated_list_build)->RangeMultiplier(100)->Range(100, 1'000'000);
+
+static void vector_list_build(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  for (auto _ : s) {
+    auto objects = std::vector<relocatable_object>();
+    auto list = relocatable_list_type();
+    for (auto i = size_t(0); i < n; ++i) {
+      objects.emplace_back();
+      list.push_back(objects.back());
+    }
+    benchmark::DoNotOptimize(list.back());
+    list.clear();
+  }
+  s.counters["ops"] = benchmark::Counter(double(s.iterations()) * n, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(vector_list_build)->RangeMultiplier(100)->Range(100, 1'000'000);
+
+static void vector_forward_list_build(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  for (auto _ : s) {
+    auto objects = std::vector<relocatable_object>();
+    auto list = relocatable_forward_list_type();
+    for (auto i = size_t(0); i < n; ++i) {
+      auto old = objects.data();
+      objects.emplace_back();
+      if (objects.data() != old) { list.relink_after_move(old, old + objects.size() - 1, objects.data()); }
+      list.push_back(objects.back());
+    }
+    benchmark::DoNotOptimize(list.back());
+  }
+  s.counters["ops"] = benchmark::Counter(double(s.iterations()) * n, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(vector_forward_list_build)->RangeMultiplier(100)->Range(100, 1'000'000);
+
+// Elements allocated one at a time are interleaved with other allocations of
+// the same size, as in a long running program.
+static void allocated_list_sum(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  auto objects = std::vector<std::unique_ptr<object>>();
+  auto garbage = std::vector<std::unique_ptr<object>>();
+  auto list = list_type();
+  for (auto i = size_t(0); i < n; ++i) {
+    garbage.emplace_back(std::make_unique<object>());
+    objects.emplace_back(std::make_unique<object>());
+    list.push_back(*objects.back());
+  }
+  garbage.clear();
+
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret =
+        transform_reduce(list.begin(), list.end(), 0, std::plus<>{}, [](object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+  }
+  s.counters["ops"] = benchmark::Counter(double(s.iterations()) * n, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(allocated_list_sum)->RangeMultiplier(100)->Range(100, 1'000'000);
+
+static void vector_list_sum(benchmark::State& s) {
+  auto n = size_t(s.range(0));
+  auto objects = std::vector<relocatable_object>();
+  auto list = relocatable_list_type();
+  for (auto i = size_t(0); i < n; ++i) {
+    objects.emplace_back();
+    list.push_back(objects.back());
+  }
+
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = transform_reduce(list.begin(), list.end(), 0, std::plus<>{},
+                                [](relocatable_object const& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+  }
+  s.counters["ops"] = benchmark::Counter(double(s.iterations()) * n, benchmark::Counter::kIsRate);
+  list.clear();
+}
+
+BENCHMARK(vector_list_sum)->RangeMultiplier(100)->Range(100, 1'000'000);
+
+} // namespace perf
@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Lookups of a 4-byte key in lists of 512-byte objects, linked either through
+// embedded hooks, which makes each step of the traversal touch the object, or
+// through side hooks holding copies of the keys. The looked up key is absent,
+// so that the whole list is walked.
+
+#include "pleione/intrusive/list.hpp"
+#include "pleione/intrusive/side_list.hpp"
+
+#include <functional>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::list_hook hook_;
+  std::uint32_t key_ = 0;
+  char payload_[512 - sizeof(pleione::intrusive::list_hook) - sizeof(std::uint32_t)];
+};
+
+static_assert(sizeof(object) == 512);
+
+using list_type = pleione::intrusive::list<object, &object::hook_>;
+using side_list_type = pleione::intrusive::side_list<object, std::uint32_t>;
+
+static constexpr std::uint32_t missing_key = std::uint32_t(-1);
+
+template<template<typename> typename T> void list_find(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  auto list = list_type();
+  for (auto p : pointers) {
+    p->key_ = std::uint32_t(p - objects.data());
+    list.push_back(*p);
+  }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto it = find_if(list.begin(), list.end(), [](object const& obj) { return obj.key_ == missing_key; });
+    benchmark::DoNotOptimize(it);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(list_find);
+
+template<template<typename> typename T> void side_list_find(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  auto hooks = std::vector<pleione::intrusive::side_list_hook<std::uint32_t>>(objects.size());
+  auto list = side_list_type(objects.data(), hooks.data());
+  for (auto p : pointers) { list.push_back(*p, std::uint32_t(p - objects.data())); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto it = list.find(missing_key);
+    benchmark::DoNotOptimize(it);
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(side_list_find);
+
+// Visits every object, so that the side list has to access the objects too.
+template<template<typename> typename T> void list_for_each(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = list_type();
+  for (auto p : pointers) { list.push_back(*p); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(list.begin(), list.end(), [](object& obj) { benchmark::DoNotOptimize(obj.key_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(list_for_each);
+
+template<template<typename> typename T> void side_list_for_each(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  auto hooks = std::vector<pleione::intrusive::side_list_hook<std::uint32_t>>(objects.size());
+  auto list = side_list_type(objects.data(), hooks.data());
+  for (auto p : pointers) { list.push_back(*p, std::uint32_t(p - objects.data())); }
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(list.begin(), list.end(), [](object& obj) { benchmark::DoNotOptimize(obj.key_); });
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(side_list_for_each);
+
+} // namespace perf
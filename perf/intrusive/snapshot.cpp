@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Warm restart of a list: relinking all elements into a new list compared with
+// mapping a saved snapshot. Each iteration ends with a traversal of the list,
+// so that the lazily loaded snapshot pays for all its page faults.
+
+#include "pleione/intrusive/list.hpp"
+#include "pleione/intrusive/snapshot.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::offset_list_hook hook_;
+  int value_ = 0;
+};
+
+using list_type = pleione::intrusive::list<object, &object::hook_>;
+
+static int sum(list_type const& list) {
+  return transform_reduce(list.begin(), list.end(), 0, std::plus<>{}, [](object const& obj) { return obj.value_; });
+}
+
+// Saves a snapshot with the elements linked in the order given by the data set.
+class saved_snapshot {
+  std::string path_ = "/tmp/pleione_perf_snapshot";
+
+public:
+  template<template<typename> typename T> explicit saved_snapshot(T<object> data_set, size_t n) {
+    auto s = pleione::intrusive::snapshot::create(sizeof(list_type) + n * sizeof(object));
+    auto list = s->construct<list_type>();
+    s->set_root(*list);
+    auto objects = s->construct_n<object>(n);
+    auto [original, pointers] = data_set(n);
+    for (auto p : pointers) { list->push_back(objects[p - original.data()]); }
+    s->save(path_.c_str());
+  }
+  ~saved_snapshot() { std::remove(path_.c_str()); }
+
+  char const* path() const noexcept { return path_.c_str(); }
+};
+
+template<template<typename> typename T> void rebuild(benchmark::State& s) {
+  auto [objects, pointers] = T<object>{}(size_t(s.range(0)));
+  (void)objects;
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto list = list_type();
+    for (auto p : pointers) { list.push_back(*p); }
+    benchmark::DoNotOptimize(sum(list));
+    list.clear();
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(rebuild);
+
+template<template<typename> typename T> void reload(benchmark::State& s, pleione::intrusive::snapshot_load mode) {
+  auto n = size_t(s.range(0));
+  auto saved = saved_snapshot(T<object>{}, n);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto snapshot = pleione::intrusive::snapshot::load(saved.path(), mode);
+    benchmark::DoNotOptimize(sum(*snapshot->root<list_type>()));
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * n, benchmark::Counter::kIsRate);
+}
+
+template<template<typename> typename T> void reload_lazy(benchmark::State& s) {
+  reload<T>(s, pleione::intrusive::snapshot_load::lazy);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(reload_lazy);
+
+template<template<typename> typename T> void reload_populate(benchmark::State& s) {
+  reload<T>(s, pleione::intrusive::snapshot_load::populate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(reload_populate);
+
+} // namespace perf
@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+struct object {
+  pleione::intrusive::list_hook hook_;
+  pleione::intrusive::forward_list_hook forward_hook_;
+  int value_ = 0;
+};
+
+static auto by_value = [](object const& a, object const& b) { return a.value_ < b.value_; };
+
+template<template<typename> typename T> static auto make_objects(size_t n) {
+  auto data = T<object>{}(n);
+  auto eng = std::default_random_engine(0);
+  auto dist = std::uniform_int_distribution<int>();
+  for (auto& obj : std::get<0>(data)) { obj.value_ = dist(eng); }
+  return data;
+}
+
+template<template<typename> typename T> void list_sort(benchmark::State& s) {
+  auto [objects, pointers] = make_objects<T>(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    s.PauseTiming();
+    list.clear();
+    for (auto p : pointers) { list.push_back(*p); }
+    s.ResumeTiming();
+    list.sort(by_value);
+    benchmark::ClobberMemory();
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(list_sort);
+
+template<template<typename> typename T> void list_vector_sort(benchmark::State& s) {
+  auto [objects, pointers] = make_objects<T>(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::list<object, &object::hook_>();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    s.PauseTiming();
+    list.clear();
+    for (auto p : pointers) { list.push_back(*p); }
+    s.ResumeTiming();
+    auto sorted = std::vector<object*>();
+    sorted.reserve(list.size());
+    for (auto& obj : list) { sorted.emplace_back(&obj); }
+    std::stable_sort(sorted.begin(), sorted.end(), [](object* a, object* b) { return by_value(*a, *b); });
+    list.clear();
+    for (auto p : sorted) { list.push_back(*p); }
+    benchmark::ClobberMemory();
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(list_vector_sort);
+
+template<template<typename> typename T> void forward_list_sort(benchmark::State& s) {
+  auto [objects, pointers] = make_objects<T>(size_t(s.range(0)));
+  (void)objects;
+  auto list = pleione::intrusive::forward_list<object, &object::forward_hook_>();
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    s.PauseTiming();
+    list.clear();
+    for (auto it = pointers.rbegin(); it != pointers.rend(); ++it) { list.push_front(**it); }
+    s.ResumeTiming();
+    list.sort(by_value);
+    benchmark::ClobberMemory();
+    ++iterations;
+  }
+  s.counters["ops"] = benchmark::Counter(double(iterations) * pointers.size(), benchmark::Counter::kIsRate);
+}
+
+PLEIONE_DATA_SET_PERF_TEST(forward_list_sort);
+
+} // namespace perf
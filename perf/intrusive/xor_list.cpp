@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// XOR-linked lists compared with doubly-linked ones. The "bytes" counter is
+// the footprint of an element: a value and a hook.
+
+#include "pleione/intrusive/list.hpp"
+#include "pleione/intrusive/xor_list.hpp"
+
+#include <functional>
+
+#include "../data_set.hpp"
+
+namespace perf {
+
+using namespace data_set;
+
+template<typename Hook> struct object {
+  Hook hook_;
+  int value_ = 0;
+};
+
+using list_object = object<pleione::intrusive::list_hook>;
+using xor_list_object = object<pleione::intrusive::xor_list_hook>;
+
+using list_type = pleione::intrusive::list<list_object, &list_object::hook_>;
+using xor_list_type = pleione::intrusive::xor_list<xor_list_object, &xor_list_object::hook_>;
+
+template<typename List> static List make_list(std::vector<typename List::value_type*> const& pointers) {
+  auto list = List();
+  for (auto p : pointers) { list.push_back(*p); }
+  return list;
+}
+
+template<typename List> static void report_ops(benchmark::State& s, uint64_t ops) {
+  s.counters["ops"] = benchmark::Counter(double(ops), benchmark::Counter::kIsRate);
+  s.counters["bytes"] = double(sizeof(typename List::value_type));
+}
+
+template<typename List, template<typename> typename T> void for_each(benchmark::State& s) {
+  auto [objects, pointers] = T<typename List::value_type>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list<List>(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for_each(list.begin(), list.end(), [](auto& obj) { benchmark::DoNotOptimize(obj.value_); });
+    ++iterations;
+  }
+  report_ops<List>(s, iterations * pointers.size());
+}
+
+template<typename List, template<typename> typename T> void reverse_iterate(benchmark::State& s) {
+  auto [objects, pointers] = T<typename List::value_type>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list<List>(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    for (auto it = list.rbegin(); it != list.rend(); ++it) { benchmark::DoNotOptimize(it->value_); }
+    ++iterations;
+  }
+  report_ops<List>(s, iterations * pointers.size());
+}
+
+template<typename List, template<typename> typename T> void transform_reduce(benchmark::State& s) {
+  auto [objects, pointers] = T<typename List::value_type>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list<List>(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    benchmark::ClobberMemory();
+    auto ret = transform_reduce(list.begin(), list.end(), 0, std::plus<>{}, [](auto& obj) { return obj.value_; });
+    benchmark::DoNotOptimize(ret);
+    ++iterations;
+  }
+  report_ops<List>(s, iterations * pointers.size());
+}
+
+template<typename List, template<typename> typename T> void push_back_pop_front(benchmark::State& s) {
+  auto [objects, pointers] = T<typename List::value_type>{}(size_t(s.range(0)));
+  (void)objects;
+  auto list = make_list<List>(pointers);
+
+  uint64_t iterations = 0;
+  for (auto _ : s) {
+    auto& obj = list.front();
+    list.pop_front();
+    list.push_back(obj);
+    ++iterations;
+  }
+  report_ops<List>(s, iterations * 2);
+}
+
+template<template<typename> typename T> void list_for_each(benchmark::State& s) { for_each<list_type, T>(s); }
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(list_for_each);
+
+template<template<typename> typename T> void xor_list_for_each(benchmark::State& s) { for_each<xor_list_type, T>(s); }
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(xor_list_for_each);
+
+template<template<typename> typename T> void list_reverse_iterate(benchmark::State& s) {
+  reverse_iterate<list_type, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(list_reverse_iterate);
+
+template<template<typename> typename T> void xor_list_reverse_iterate(benchmark::State& s) {
+  reverse_iterate<xor_list_type, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(xor_list_reverse_iterate);
+
+template<template<typename> typename T> void list_transform_reduce(benchmark::State& s) {
+  transform_reduce<list_type, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(list_transform_reduce);
+
+template<template<typename> typename T> void xor_list_transform_reduce(benchmark::State& s) {
+  transform_reduce<xor_list_type, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(xor_list_transform_reduce);
+
+template<template<typename> typename T> void list_push_back_pop_front(benchmark::State& s) {
+  push_back_pop_front<list_type, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(list_push_back_pop_front);
+
+template<template<typename> typename T> void xor_list_push_back_pop_front(benchmark::State& s) {
+  push_back_pop_front<xor_list_type, T>(s);
+}
+
+PLEIONE_DATA_SET_LARGE_PERF_TEST(xor_list_push_back_pop_front);
+
+} // namespace perf
@@ -22,6 +22,10 @@
 
 #include "pleione/detail/container_of.hpp"
 
+#include <memory>
+#include <string>
+#include <utility>
+
 #include <gtest/gtest.h>
 
 struct foo {
@@ -72,3 +76,148 @@ TEST(container_of, non_standard_layout) {
   auto& b = *static_cast<vbar*>(&v);
   EXPECT_EQ(&(pleione::detail::container_of<vbaz, int>(&vbaz::y, b.y)), &v);
 }
+
+// With GCC the offsets of members of trivially destructible structures are
+// constant expressions, so container_of<Structure, Member>() is a constant
+// subtraction.
+#if PLEIONE_CONSTANT_OFFSETS
+static_assert(pleione::detail::offset_of<bar, &bar::x>() == 0);
+static_assert(pleione::detail::offset_of<bar, &bar::y>() == offsetof(bar, y));
+static_assert(pleione::detail::offset_of<bar, &bar::z>() == offsetof(bar, z));
+#endif
+
+struct base {
+  long a;
+  int b;
+};
+
+struct derived : base {
+  int c;
+};
+
+struct other_base {
+  char d[12];
+};
+
+struct multiple : other_base, derived {
+  int e;
+};
+
+#if PLEIONE_CONSTANT_OFFSETS
+static_assert(pleione::detail::offset_of<base, &base::b>() == sizeof(long));
+static_assert(pleione::detail::offset_of<derived, &derived::c>() == sizeof(base));
+static_assert(pleione::detail::offset_of<multiple, &base::b>() == 16 + sizeof(long));
+#endif
+
+struct nontrivial {
+  int x = 1;
+  std::string y;
+  int z = 2;
+};
+
+TEST(offset_of, compile_time) {
+  auto m = multiple{};
+  auto e = pleione::detail::offset_of<multiple const, &multiple::e>();
+  EXPECT_EQ(e, reinterpret_cast<char*>(&m.e) - reinterpret_cast<char*>(&m));
+  EXPECT_EQ((pleione::detail::offset_of<multiple, &base::b>()),
+            (pleione::detail::offset_of<multiple, int>(&multiple::b)));
+  EXPECT_EQ((pleione::detail::offset_of<nontrivial, &nontrivial::z>()), offsetof(nontrivial, z));
+  EXPECT_EQ((pleione::detail::offset_of<nontrivial, &nontrivial::y>()),
+            (pleione::detail::offset_of<nontrivial, std::string>(&nontrivial::y)));
+}
+
+TEST(container_of, compile_time) {
+  auto b = bar{};
+  EXPECT_EQ(&(pleione::detail::container_of<bar, &bar::x>(b.x)), &b);
+  EXPECT_EQ(&(pleione::detail::container_of<bar, &bar::y>(b.y)), &b);
+  EXPECT_EQ(&(pleione::detail::container_of<bar const, &bar::z>(std::as_const(b).z)), &b);
+
+  auto m = multiple{};
+  EXPECT_EQ(&(pleione::detail::container_of<multiple, &base::b>(m.b)), &m);
+  EXPECT_EQ(&(pleione::detail::container_of<multiple, &multiple::e>(m.e)), &m);
+
+  auto n = nontrivial{};
+  EXPECT_EQ(&(pleione::detail::container_of<nontrivial, &nontrivial::y>(n.y)), &n);
+
+  auto v = vbaz{};
+  EXPECT_EQ(&(pleione::detail::container_of<vbaz, &vbaz::x>(v.x)), &v);
+  EXPECT_EQ(&(pleione::detail::container_of<vbaz, &vbaz::w>(v.w)), &v);
+}
+
+#if PLEIONE_CONSTANT_OFFSETS
+static_assert(pleione::detail::base_offset_of<multiple, other_base>() == 0);
+static_assert(pleione::detail::base_offset_of<multiple, derived>() == 16);
+static_assert(pleione::detail::base_offset_of<multiple, base>() == 16);
+#endif
+
+struct nontrivial_multiple : other_base, nontrivial {};
+
+TEST(base_offset_of, run_time) {
+  auto m = multiple{};
+  auto offset = pleione::detail::base_offset_of<multiple, base>();
+  EXPECT_EQ(offset, reinterpret_cast<char*>(static_cast<base*>(&m)) - reinterpret_cast<char*>(&m));
+}
+
+struct virtual_derived : virtual base {};
+
+static_assert(pleione::detail::is_virtual_base_of<virtual_derived, base>::value);
+static_assert(!pleione::detail::is_virtual_base_of<multiple, base>::value);
+static_assert(!pleione::detail::is_virtual_base_of<base, base>::value);
+
+TEST(base_offset_of, non_trivially_destructible) {
+  auto m = nontrivial_multiple{};
+  EXPECT_EQ((pleione::detail::base_offset_of<nontrivial_multiple, nontrivial>()),
+            reinterpret_cast<char*>(static_cast<nontrivial*>(&m)) - reinterpret_cast<char*>(&m));
+  EXPECT_EQ((pleione::detail::base_offset_of<nontrivial_multiple, other_base>()), 0);
+}
+
+struct abstract {
+  int x;
+  virtual ~abstract() = default;
+  virtual int value() const = 0;
+  int y;
+};
+
+struct concrete : abstract {
+  int value() const override { return 1; }
+};
+
+struct abstract_trivial {
+  int x;
+  virtual int value() const = 0;
+  int y;
+};
+
+struct concrete_trivial : abstract_trivial {
+  int value() const override { return 2; }
+};
+
+TEST(container_of, abstract) {
+  auto c = concrete{};
+  abstract& a = c;
+  EXPECT_EQ(&(pleione::detail::container_of<abstract, &abstract::y>(a.y)), &a);
+  EXPECT_EQ(&(pleione::detail::container_of<abstract, int>(&abstract::x, a.x)), &a);
+
+  auto t = concrete_trivial{};
+  abstract_trivial& at = t;
+  EXPECT_EQ(&(pleione::detail::container_of<abstract_trivial, &abstract_trivial::y>(at.y)), &at);
+  EXPECT_EQ((pleione::detail::base_offset_of<concrete_trivial, abstract_trivial>()), 0);
+}
+
+struct large {
+  char head;
+  char padding[300000];
+  int tail;
+};
+
+// Members beyond constant_offset_limit are found at run time.
+#if PLEIONE_CONSTANT_OFFSETS
+static_assert(pleione::detail::offset_of<large, &large::head>() == 0);
+static_assert(pleione::detail::constant_offset_v<large, &large::tail> == -1);
+#endif
+
+TEST(container_of, large_offset) {
+  auto l = std::make_unique<large>();
+  EXPECT_EQ((pleione::detail::offset_of<large, &large::tail>()), offsetof(large, tail));
+  EXPECT_EQ(&(pleione::detail::container_of<large, &large::tail>(l->tail)), l.get());
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace pleione::intrusive;
+
+struct by_lru;
+struct by_owner;
+struct by_queue;
+
+struct conn : list_base_hook<by_lru>, list_base_hook<by_owner>, forward_list_base_hook<by_queue> {
+  int value = 0;
+  std::string name;
+
+  void set(int v) {
+    value = v;
+    name = std::to_string(v);
+  }
+};
+
+using lru_list = list<conn, base_hook<by_lru>>;
+using owner_list = list<conn, base_hook<by_owner>, false>;
+using queue_list = forward_list<conn, base_hook<by_queue>, true>;
+
+static_assert(sizeof(list_base_hook<by_lru>) == sizeof(list_hook));
+static_assert(sizeof(forward_list_base_hook<by_queue>) == sizeof(forward_list_hook));
+static_assert(!std::is_trivially_destructible_v<conn>);
+
+template<typename Range> static std::vector<int> values(Range const& range) {
+  auto result = std::vector<int>();
+  for (auto& c : range) { result.emplace_back(c.value); }
+  return result;
+}
+
+TEST(intrusive_base_hook, several_lists) {
+  auto conns = std::array<conn, 4>{};
+  for (auto i = 0u; i < conns.size(); ++i) { conns[i].set(int(i)); }
+  auto lru = lru_list(conns.begin(), conns.end());
+  auto owner = owner_list();
+  auto queue = queue_list();
+  for (auto& c : conns) {
+    owner.push_front(c);
+    queue.push_back(c);
+  }
+
+  EXPECT_EQ(values(lru), (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_EQ(values(owner), (std::vector<int>{3, 2, 1, 0}));
+  EXPECT_EQ(values(queue), (std::vector<int>{0, 1, 2, 3}));
+
+  lru.erase(std::next(lru.begin()));
+  lru.push_back(conns[1]);
+  queue.pop_front();
+  EXPECT_EQ(values(lru), (std::vector<int>{0, 2, 3, 1}));
+  EXPECT_EQ(values(owner), (std::vector<int>{3, 2, 1, 0}));
+  EXPECT_EQ(values(queue), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(&lru.back(), &conns[1]);
+  EXPECT_EQ(&queue.front(), &conns[1]);
+  EXPECT_EQ(queue.last()->name, "3");
+
+  lru.clear();
+  owner.clear();
+  queue.clear();
+}
+
+TEST(intrusive_base_hook, const_iteration) {
+  auto conns = std::array<conn, 3>{};
+  for (auto i = 0u; i < conns.size(); ++i) { conns[i].set(int(i) + 1); }
+  auto lru = lru_list(conns.begin(), conns.end());
+  auto const& clru = lru;
+  EXPECT_EQ(&*clru.begin(), &conns[0]);
+  EXPECT_EQ(&*std::prev(clru.end()), &conns[2]);
+  EXPECT_EQ(std::prev(clru.end())->name, "3");
+  EXPECT_EQ(values(clru), (std::vector<int>{1, 2, 3}));
+  lru.clear();
+}
+
+TEST(intrusive_base_hook, algorithms) {
+  auto conns = std::vector<conn>(100);
+  for (auto i = 0u; i < conns.size(); ++i) { conns[i].set(int(i)); }
+  auto lru = lru_list(conns.begin(), conns.end());
+  auto queue = queue_list(conns.begin(), conns.end());
+
+  auto sum = 0;
+  for_each(pleione::prefetch<true>{}, lru.begin(), lru.end(), [&](conn& c) { sum += c.value; });
+  EXPECT_EQ(sum, 4950);
+  sum = 0;
+  for_each(pleione::prefetch<true>{}, queue.begin(), queue.end(), [&](conn& c) { sum += c.value; });
+  EXPECT_EQ(sum, 4950);
+
+  auto total = transform_reduce(pleione::prefetch<true>{}, lru.begin(), lru.end(), 0, std::plus<>{},
+                                [](conn const& c) { return c.value; });
+  EXPECT_EQ(total, 4950);
+  auto it = find_if(queue.begin(), queue.end(), [](conn const& c) { return c.value == 42; });
+  ASSERT_NE(it, queue.end());
+  EXPECT_EQ(&*it, &conns[42]);
+
+  lru.sort([](conn const& a, conn const& b) { return a.value > b.value; });
+  queue.sort([](conn const& a, conn const& b) { return a.value > b.value; });
+  EXPECT_EQ(lru.front().value, 99);
+  EXPECT_EQ(queue.front().value, 99);
+  EXPECT_TRUE(std::equal(lru.begin(), lru.end(), queue.begin(), queue.end(),
+                         [](conn const& a, conn const& b) { return &a == &b; }));
+
+  lru.clear();
+  queue.clear();
+}
+
+TEST(intrusive_base_hook, member_and_base_hooks) {
+  struct item : list_base_hook<by_lru> {
+    list_hook member;
+    int value = 0;
+  };
+
+  auto items = std::array<item, 3>{};
+  for (auto i = 0u; i < items.size(); ++i) { items[i].value = int(i); }
+  auto by_base = list<item, base_hook<by_lru>>(items.begin(), items.end());
+  auto by_member = list<item, &item::member>(items.rbegin(), items.rend());
+  EXPECT_EQ(values(by_base), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(values(by_member), (std::vector<int>{2, 1, 0}));
+  by_base.clear();
+  by_member.clear();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+struct test_arena {
+  static inline std::byte* base_ = nullptr;
+  static std::byte* base() noexcept { return base_; }
+};
+
+struct foo {
+  int value = 0;
+  pleione::intrusive::compact_list_hook<test_arena> hook;
+  pleione::intrusive::compact_forward_list_hook<test_arena> forward_hook;
+};
+
+static_assert(sizeof(pleione::intrusive::compact_list_hook<test_arena>) == 8);
+static_assert(sizeof(pleione::intrusive::compact_forward_list_hook<test_arena>) == 4);
+static_assert(std::is_trivially_default_constructible_v<pleione::intrusive::compact_list_hook<test_arena>>);
+
+using list_type = pleione::intrusive::list<foo, &foo::hook>;
+using forward_list_type = pleione::intrusive::forward_list<foo, &foo::forward_hook, true>;
+
+// All hooks, including the ones of the list headers, have to be in the arena.
+struct arena {
+  int reserved = 0;
+  list_type list;
+  list_type other;
+  forward_list_type forward_list;
+  foo objects[64];
+};
+
+// The base has to be set before the list headers are constructed.
+class intrusive_compact : public ::testing::Test {
+  std::unique_ptr<std::aligned_storage_t<sizeof(arena), alignof(arena)>> storage_ =
+      std::make_unique<std::aligned_storage_t<sizeof(arena), alignof(arena)>>();
+
+protected:
+  arena* arena_ = nullptr;
+
+  void SetUp() override {
+    test_arena::base_ = reinterpret_cast<std::byte*>(storage_.get());
+    arena_ = new (storage_.get()) arena;
+    for (auto idx = 0; idx < 64; idx++) { arena_->objects[idx].value = idx; }
+  }
+  void TearDown() override { arena_->~arena(); }
+};
+
+template<typename List> static std::vector<int> values(List const& list) {
+  auto result = std::vector<int>();
+  for (auto& f : list) { result.emplace_back(f.value); }
+  return result;
+}
+
+TEST_F(intrusive_compact, list) {
+  auto& l = arena_->list;
+  auto& fs = arena_->objects;
+  EXPECT_TRUE(l.empty());
+
+  l.push_back(fs[1]);
+  l.push_back(fs[2]);
+  l.push_front(fs[0]);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(l.size(), 3);
+  EXPECT_EQ(&l.front(), &fs[0]);
+  EXPECT_EQ(&l.back(), &fs[2]);
+  EXPECT_EQ(&*std::prev(l.end()), &fs[2]);
+  EXPECT_EQ(&*l.rbegin(), &fs[2]);
+
+  l.insert(std::next(l.begin()), fs + 10, fs + 13);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 10, 11, 12, 1, 2}));
+  l.erase(std::next(l.begin(), 2));
+  EXPECT_EQ(values(l), (std::vector<int>{0, 10, 12, 1, 2}));
+  l.pop_back();
+  l.pop_front();
+  EXPECT_EQ(values(l), (std::vector<int>{10, 12, 1}));
+
+  auto& other = arena_->other;
+  other.assign(fs + 20, fs + 23);
+  l.splice(l.end(), other, std::next(other.begin()), other.end());
+  EXPECT_EQ(values(l), (std::vector<int>{10, 12, 1, 21, 22}));
+  EXPECT_EQ(values(other), (std::vector<int>{20}));
+  l.splice(l.begin(), other);
+  EXPECT_TRUE(other.empty());
+
+  l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+  EXPECT_EQ(values(l), (std::vector<int>{1, 10, 12, 20, 21, 22}));
+
+  auto sum = transform_reduce(l.begin(), l.end(), 0, std::plus<>{}, [](foo const& f) { return f.value; });
+  EXPECT_EQ(sum, 86);
+  EXPECT_EQ(&*find_if(pleione::prefetch<4>{}, l.begin(), l.end(), [](foo const& f) { return f.value > 15; }), &fs[20]);
+  EXPECT_EQ(count_if(l.begin(), l.end(), [](foo const& f) { return f.value % 2 == 0; }), 4);
+
+  l.clear();
+  EXPECT_TRUE(l.empty());
+}
+
+TEST_F(intrusive_compact, forward_list) {
+  auto& l = arena_->forward_list;
+  auto& fs = arena_->objects;
+  EXPECT_TRUE(l.empty());
+
+  l.push_front(fs[1]);
+  l.push_front(fs[0]);
+  l.push_back(fs[2]);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(l.size(), 3);
+  EXPECT_EQ(&l.back(), &fs[2]);
+
+  l.insert_after(l.begin(), fs + 10, fs + 13);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 10, 11, 12, 1, 2}));
+  l.erase_after(l.begin());
+  l.pop_front();
+  EXPECT_EQ(values(l), (std::vector<int>{11, 12, 1, 2}));
+
+  l.sort([](foo const& a, foo const& b) { return a.value > b.value; });
+  EXPECT_EQ(values(l), (std::vector<int>{12, 11, 2, 1}));
+  EXPECT_EQ(&l.back(), &fs[1]);
+
+  auto sum = transform_reduce(l.begin(), l.end(), 0, std::plus<>{}, [](foo const& f) { return f.value; });
+  EXPECT_EQ(sum, 26);
+  EXPECT_TRUE(any_of(l.begin(), l.end(), [](foo const& f) { return f.value == 2; }));
+
+  l.clear();
+  EXPECT_TRUE(l.empty());
+}
+
+TEST_F(intrusive_compact, many_elements) {
+  auto& l = arena_->list;
+  auto& fs = arena_->objects;
+  for (auto idx = 63; idx >= 0; idx -= 2) { l.push_back(fs[idx]); }
+  for (auto idx = 0; idx < 64; idx += 2) { l.push_back(fs[idx]); }
+  l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+
+  auto expected = std::vector<int>(64);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(values(l), expected);
+
+  auto reversed = std::vector<int>();
+  for (auto it = l.rbegin(); it != l.rend(); ++it) { reversed.emplace_back(it->value); }
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(reversed, expected);
+}
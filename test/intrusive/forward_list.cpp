@@ -21,10 +21,16 @@
  */
 
 #include "pleione/intrusive/forward_list.hpp"
+#include "pleione/parallel.hpp"
 
 #include <array>
+#include <functional>
 #include <list>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <type_traits>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -65,10 +71,36 @@ TEST(intrusive_forward_list, move_constructor) {
   auto fs = std::vector<foo>(8);
   auto l = list_type(fs.begin(), fs.end());
   auto l2 = std::move(l);
-  l.clear();
+  check_empty(l);
   check_equal_range(l2, fs);
 }
 
+TEST(intrusive_forward_list, moved_from) {
+  using tail_list_type = pleione::intrusive::forward_list<foo, &foo::hook, true>;
+  auto fs = std::vector<foo>(8);
+  auto l = tail_list_type(fs.begin(), fs.begin() + 4);
+  auto l2 = std::move(l);
+  EXPECT_TRUE(l.empty());
+  EXPECT_EQ(l.size(), 0);
+  l.push_back(fs[4]);
+  l.push_back(fs[5]);
+  EXPECT_EQ(&l.front(), &fs[4]);
+  EXPECT_EQ(&l.back(), &fs[5]);
+  EXPECT_EQ(l.size(), 2);
+  EXPECT_TRUE(std::equal(l2.begin(), l2.end(), fs.begin(), fs.begin() + 4));
+  EXPECT_EQ(&l2.back(), &fs[3]);
+  EXPECT_EQ(l2.size(), 4);
+
+  l2 = std::move(l);
+  EXPECT_TRUE(l.empty());
+  l.push_back(fs[6]);
+  EXPECT_EQ(&l.back(), &fs[6]);
+  EXPECT_TRUE(std::equal(l2.begin(), l2.end(), fs.begin() + 4, fs.begin() + 6));
+  auto& self = l2;
+  l2 = std::move(self);
+  EXPECT_EQ(l2.size(), 2);
+}
+
 TEST(intrusive_forward_list, move_assignment) {
   auto fs = std::vector<foo>(8);
   auto l = list_type();
@@ -531,18 +563,19 @@ struct object {
   size_t value;
 
   friend bool operator==(object const& a, object const& b) noexcept { return a.value == b.value; }
+  friend bool operator<(object const& a, object const& b) noexcept { return a.value < b.value; }
 };
 
 size_t value_counter = 0;
 
-struct state {
+template<bool TrackTail> struct basic_state {
   std::list<object> std_;
-  pleione::intrusive::forward_list<object, &object::hook> pln_;
+  pleione::intrusive::forward_list<object, &object::hook, TrackTail> pln_;
 
 public:
-  state() = default;
-  state(state&&) = default;
-  state(state const& other) {
+  basic_state() = default;
+  basic_state(basic_state&&) = default;
+  basic_state(basic_state const& other) {
     for (auto it = other.std_.rbegin(); it != other.std_.rend(); ++it) {
       auto& obj = *it;
       auto& nobj = std_.emplace_front();
@@ -560,6 +593,12 @@ public:
     pln_.push_front(obj);
   }
 
+  void push_back() {
+    auto& obj = std_.emplace_back();
+    obj.value = value_counter++;
+    pln_.push_back(obj);
+  }
+
   void pop_front() {
     pln_.pop_front();
     std_.pop_front();
@@ -598,24 +637,31 @@ public:
     } else {
       EXPECT_EQ(pln_.begin(), pln_.end());
     }
+    if constexpr (TrackTail) {
+      EXPECT_EQ(std_.size(), pln_.size());
+      if (!std_.empty()) { EXPECT_EQ(&std_.back(), &pln_.back()); }
+    }
     EXPECT_EQ(std_.size(), std::distance(pln_.begin(), pln_.end()));
     EXPECT_TRUE(std::equal(std_.begin(), std_.end(), pln_.begin(), pln_.end()));
   }
 
   bool check_bounds() const { return std_.size() < 8; }
 
-  friend bool operator==(state const& a, state const& b) noexcept { return a.std_.size() == b.std_.size(); }
+  friend bool operator==(basic_state const& a, basic_state const& b) noexcept {
+    return a.std_.size() == b.std_.size();
+  }
 };
 
 namespace std {
 
-template<> struct hash<::state> {
-  size_t operator()(state const& st) const noexcept { return st.size(); }
+template<bool TrackTail> struct hash<::basic_state<TrackTail>> {
+  size_t operator()(::basic_state<TrackTail> const& st) const noexcept { return st.size(); }
 };
 
 } // namespace std
 
-TEST(intrusive_forward_list, state_walk) {
+template<bool TrackTail> static void walk_states() {
+  using state = basic_state<TrackTail>;
   state_walk<state>(
       {
           [](state const& in) {
@@ -623,6 +669,11 @@ TEST(intrusive_forward_list, state_walk) {
             out.emplace_back(in).push_front();
             return out;
           },
+          [](state const& in) {
+            std::vector<state> out;
+            if constexpr (TrackTail) { out.emplace_back(in).push_back(); }
+            return out;
+          },
           [](state const& in) {
             std::vector<state> out;
             if (!in.empty()) { out.emplace_back(in).pop_front(); }
@@ -656,6 +707,14 @@ TEST(intrusive_forward_list, state_walk) {
       std::mem_fn(&state::validate), std::mem_fn(&state::check_bounds));
 }
 
+TEST(intrusive_forward_list, state_walk) {
+  walk_states<false>();
+}
+
+TEST(intrusive_forward_list, tail_tracking_state_walk) {
+  walk_states<true>();
+}
+
 TEST(intrusive_forward_list, for_each) {
   auto fs = std::vector<foo>(16);
   for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = idx; }
@@ -688,3 +747,320 @@ TEST(intrusive_forward_list, for_each) {
     EXPECT_TRUE(std::all_of(visited.begin(), visited.end(), [](int x) { return x == 1; }));
   }
 }
+
+TEST(intrusive_forward_list, find_count) {
+  auto fs = std::vector<foo>(16);
+  for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = idx; }
+  auto const l = list_type(fs.begin(), fs.end());
+
+  auto it = find_if(l.begin(), l.end(), [](foo const& object) { return object.value == 5; });
+  EXPECT_EQ(&*it, &fs[5]);
+  EXPECT_EQ(find_if(l.begin(), l.end(), [](foo const& object) { return object.value == 16; }), l.end());
+  EXPECT_TRUE(any_of(l.begin(), l.end(), [](foo const& object) { return object.value == 15; }));
+  EXPECT_FALSE(any_of(l.begin(), l.end(), [](foo const& object) { return object.value < 0; }));
+  EXPECT_TRUE(all_of(l.begin(), l.end(), [](foo const& object) { return object.value < 16; }));
+  EXPECT_FALSE(all_of(l.begin(), l.end(), [](foo const& object) { return object.value < 15; }));
+  EXPECT_TRUE(none_of(l.begin(), l.end(), [](foo const& object) { return object.value > 15; }));
+  EXPECT_EQ(count_if(l.begin(), l.end(), [](foo const& object) { return object.value % 2; }), 8);
+  EXPECT_EQ(count_if(l.end(), l.end(), [](foo const&) { return true; }), 0);
+}
+
+TEST(intrusive_forward_list, parallel) {
+  for (auto n : {0u, 1u, 255u, 256u, 257u, 1000u, 10000u}) {
+    auto fs = std::vector<foo>(n);
+    for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = 0; }
+    auto l = list_type(fs.begin(), fs.end());
+    for (auto threads : {0u, 1u, 3u, 64u}) {
+      for_each(pleione::parallel{threads}, l.begin(), l.end(), [](foo& object) { object.value++; });
+      EXPECT_TRUE(std::all_of(fs.begin(), fs.end(), [](foo const& object) { return object.value == 1; }));
+      auto value = transform_reduce(pleione::parallel{threads}, l.begin(), l.end(), 4, std::plus<>{},
+                                    [](foo& object) { return object.value--; });
+      EXPECT_EQ(value, 4 + int(n));
+      EXPECT_TRUE(std::all_of(fs.begin(), fs.end(), [](foo const& object) { return object.value == 0; }));
+    }
+  }
+}
+
+template<typename Prefetch> static void check_prefetch_depth(Prefetch pf) {
+  for (auto n = 0u; n < 20; n++) {
+    auto fs = std::vector<foo>(n);
+    for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = idx; }
+    auto l = list_type(fs.begin(), fs.end());
+
+    auto visited = std::vector<int>();
+    for_each(pf, l.begin(), l.end(), [&](auto const& object) { visited.emplace_back(object.value); });
+    auto expected = std::vector<int>(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(visited, expected);
+
+    for (auto target = 0u; target <= n; target++) {
+      auto it = find_if(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) == target; });
+      if (target < n) {
+        EXPECT_EQ(&*it, &fs[target]);
+      } else {
+        EXPECT_EQ(it, l.end());
+      }
+      EXPECT_EQ(any_of(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) == target; }),
+                target < n);
+    }
+    EXPECT_EQ(any_of(pf, l.begin(), l.end(), [&](auto const& object) { return object.value == int(n / 2); }), n > 0);
+    EXPECT_TRUE(all_of(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) < n; }));
+    EXPECT_EQ(all_of(pf, l.begin(), l.end(), [](auto const& object) { return object.value % 2 == 0; }), n < 2);
+    EXPECT_TRUE(none_of(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) >= n; }));
+    EXPECT_EQ(count_if(pf, l.begin(), l.end(), [](auto const& object) { return object.value % 3 == 0; }),
+              (n + 2) / 3);
+
+    auto value = transform_reduce(pf, l.begin(), l.end(), 4, std::plus<>{}, [](auto const& object) {
+      return object.value;
+    });
+    EXPECT_EQ(value, 4 + int(n * (n - 1) / 2));
+  }
+}
+
+TEST(intrusive_forward_list, prefetch_depth) {
+  check_prefetch_depth(pleione::prefetch<0>{});
+  check_prefetch_depth(pleione::prefetch<1, pleione::locality::low>{});
+  check_prefetch_depth(pleione::prefetch<2>{});
+  check_prefetch_depth(pleione::prefetch<3, pleione::locality::moderate, true>{});
+  check_prefetch_depth(pleione::prefetch<4, pleione::locality::nta>{});
+  check_prefetch_depth(pleione::prefetch<16>{});
+}
+
+TEST(intrusive_forward_list, prefetch_members) {
+  check_prefetch_depth(pleione::prefetch<0>::members<&foo::value>{});
+  check_prefetch_depth(pleione::prefetch<1>::members<&foo::value>{});
+  check_prefetch_depth(pleione::prefetch<4, pleione::locality::nta>::members<&foo::value, &foo::hook>{});
+  check_prefetch_depth(pleione::prefetch<1, pleione::locality::low, true>::object{});
+  check_prefetch_depth(pleione::prefetch<8>::object{});
+}
+
+TEST(intrusive_forward_list, sort) {
+  for (auto n : {0, 1, 2, 3, 7, 64, 1000}) {
+    auto fs = std::vector<foo>(n);
+    auto eng = std::default_random_engine(n);
+    auto dist = std::uniform_int_distribution<int>(0, n / 4);
+    for (auto& f : fs) { f.value = dist(eng); }
+    auto expected = std::vector<foo*>(n);
+    std::transform(fs.begin(), fs.end(), expected.begin(), [](foo& f) { return &f; });
+    std::stable_sort(expected.begin(), expected.end(), [](foo* a, foo* b) { return a->value < b->value; });
+
+    auto l = list_type(fs.begin(), fs.end());
+    l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+    EXPECT_TRUE(std::equal(l.begin(), l.end(), expected.begin(), expected.end(),
+                           [](foo const& a, foo const* b) { return &a == b; }));
+  }
+}
+
+TEST(intrusive_forward_list, sort_default_compare) {
+  auto fs = std::vector<object>(16);
+  for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = (idx * 7) % fs.size(); }
+  auto l = pleione::intrusive::forward_list<object, &object::hook>(fs.begin(), fs.end());
+  l.sort();
+  auto value = size_t(0);
+  for (auto& obj : l) { EXPECT_EQ(obj.value, value++); }
+  EXPECT_EQ(value, fs.size());
+}
+
+using tracked_list_type = pleione::intrusive::forward_list<foo, &foo::hook, true>;
+
+static_assert(sizeof(list_type) == sizeof(void*));
+
+template<typename Range> static void check_tracked(tracked_list_type& actual, Range&& range) {
+  EXPECT_EQ(actual.size(), std::distance(range.begin(), range.end()));
+  EXPECT_EQ(actual.empty(), range.begin() == range.end());
+  EXPECT_TRUE(std::equal(actual.begin(), actual.end(), range.begin(), range.end()));
+  if (!actual.empty()) {
+    EXPECT_EQ(actual.front(), *range.begin());
+    EXPECT_EQ(actual.back(), *std::prev(range.end()));
+  }
+}
+
+TEST(intrusive_forward_list, tail_tracking_push_back) {
+  auto fs = std::vector<foo>(8);
+  auto l = tracked_list_type();
+  EXPECT_EQ(l.size(), 0);
+  for (auto it = fs.begin(); it != fs.end(); ++it) {
+    l.push_back(*it);
+    check_tracked(l, std::list<std::reference_wrapper<foo>>(fs.begin(), std::next(it)));
+  }
+  EXPECT_EQ(&*l.last(), &fs.back());
+  l.clear();
+  EXPECT_EQ(l.size(), 0);
+  EXPECT_EQ(l.last(), l.before_begin());
+  l.push_back(fs.back());
+  EXPECT_EQ(l.back(), fs.back());
+
+  auto l2 = tracked_list_type(fs.begin(), std::prev(fs.end()));
+  l2.splice_after(l2.last(), l);
+  check_tracked(l2, fs);
+  EXPECT_TRUE(l.empty());
+}
+
+TEST(intrusive_forward_list, tail_tracking_move) {
+  auto fs = std::vector<foo>(8);
+  auto l = tracked_list_type(fs.begin(), fs.end());
+  auto l2 = std::move(l);
+  check_tracked(l2, fs);
+
+  auto l3 = tracked_list_type();
+  auto l4 = std::move(l3);
+  auto f = foo();
+  l4.push_back(f);
+  EXPECT_EQ(l4.size(), 1);
+  EXPECT_EQ(l4.front(), f);
+  EXPECT_EQ(l4.back(), f);
+}
+
+TEST(intrusive_forward_list, tail_tracking_splice_all) {
+  for (auto idx = 0; idx <= 8; ++idx) {
+    auto fa = std::list<foo>(8);
+    auto fb = std::list<foo>(8);
+    auto la = tracked_list_type(fa.begin(), fa.end());
+    auto lb = tracked_list_type(fb.begin(), fb.end());
+    la.splice_after(std::next(la.before_begin(), idx), lb);
+    fa.splice(std::next(fa.begin(), idx), fb);
+    check_tracked(la, fa);
+    check_tracked(lb, fb);
+
+    auto lc = tracked_list_type();
+    la.splice_after(std::next(la.before_begin(), idx), std::move(lc));
+    check_tracked(la, fa);
+  }
+}
+
+TEST(intrusive_forward_list, tail_tracking_splice_range) {
+  for (auto idx = 0; idx <= 8; ++idx) {
+    for (auto jdx = 0; jdx < 7; ++jdx) {
+      for (auto n = 0; n <= 8 - jdx; ++n) {
+        auto fa = std::list<foo>(8);
+        auto fb = std::list<foo>(8);
+        auto la = tracked_list_type(fa.begin(), fa.end());
+        auto lb = tracked_list_type(fb.begin(), fb.end());
+        auto it_b = std::next(lb.before_begin(), jdx);
+        la.splice_after(std::next(la.before_begin(), idx), lb, it_b, std::next(it_b, n + 1));
+        auto f_it_b = std::next(fb.begin(), jdx);
+        fa.splice(std::next(fa.begin(), idx), fb, f_it_b, std::next(f_it_b, n));
+        check_tracked(la, fa);
+        check_tracked(lb, fb);
+      }
+    }
+  }
+}
+
+TEST(intrusive_forward_list, tail_tracking_sort) {
+  auto fs = std::vector<foo>(16);
+  for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = int(fs.size() - idx); }
+  auto l = tracked_list_type(fs.begin(), fs.end());
+  l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+  EXPECT_EQ(l.size(), fs.size());
+  EXPECT_EQ(l.front(), fs.back());
+  EXPECT_EQ(l.back(), fs.front());
+  auto f = foo();
+  l.push_back(f);
+  EXPECT_EQ(l.back(), f);
+}
+
+struct movable {
+  int value = 0;
+  pleione::intrusive::forward_list_hook hook;
+
+  explicit movable(int v) noexcept : value(v) {}
+  movable(movable&& other) noexcept : value(other.value) {}
+};
+
+TEST(intrusive_forward_list, relinearize) {
+  using storage_type = std::aligned_storage_t<sizeof(movable), alignof(movable)>;
+  for (auto n = 0; n < 20; n++) {
+    auto source = std::make_unique<storage_type[]>(n);
+    auto destination = std::make_unique<storage_type[]>(n);
+    auto order = std::vector<int>(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(n));
+
+    auto l = pleione::intrusive::forward_list<movable, &movable::hook>();
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      l.push_front(*::new (static_cast<void*>(&source[*it])) movable(*it));
+    }
+
+    auto first = reinterpret_cast<movable*>(destination.get());
+    EXPECT_EQ(l.relinearize(first), first + n);
+
+    auto idx = 0;
+    for (auto& object : l) {
+      EXPECT_EQ(&object, first + idx);
+      EXPECT_EQ(object.value, order[idx]);
+      idx++;
+    }
+    EXPECT_EQ(idx, n);
+
+    l.clear();
+    for (auto i = 0; i < n; i++) { first[i].~movable(); }
+  }
+}
+
+TEST(intrusive_forward_list, relinearize_custom_relocate) {
+  using storage_type = std::aligned_storage_t<sizeof(movable), alignof(movable)>;
+  auto source = std::vector<std::unique_ptr<movable>>();
+  auto l = pleione::intrusive::forward_list<movable, &movable::hook>();
+  for (auto i = 0; i < 8; i++) { l.push_front(*source.emplace_back(std::make_unique<movable>(i))); }
+
+  auto destination = std::make_unique<storage_type[]>(8);
+  auto relocated = 0;
+  auto last = l.relinearize(reinterpret_cast<movable*>(destination.get()), [&](movable& from, void* to) -> movable& {
+    relocated++;
+    return *::new (to) movable(std::move(from));
+  });
+  EXPECT_EQ(relocated, 8);
+  EXPECT_EQ(last, reinterpret_cast<movable*>(destination.get()) + 8);
+  EXPECT_TRUE(std::equal(l.begin(), l.end(), source.rbegin(), source.rend(),
+                         [](movable const& a, std::unique_ptr<movable> const& b) { return a.value == b->value; }));
+}
+
+TEST(intrusive_forward_list, tail_tracking_relinearize) {
+  using storage_type = std::aligned_storage_t<sizeof(movable), alignof(movable)>;
+  auto source = std::vector<std::unique_ptr<movable>>();
+  auto l = pleione::intrusive::forward_list<movable, &movable::hook, true>();
+  for (auto i = 0; i < 8; i++) { l.push_back(*source.emplace_back(std::make_unique<movable>(i))); }
+
+  auto destination = std::make_unique<storage_type[]>(8);
+  auto first = reinterpret_cast<movable*>(destination.get());
+  l.relinearize(first);
+  EXPECT_EQ(l.size(), 8);
+  EXPECT_EQ(&l.front(), first);
+  EXPECT_EQ(&l.back(), first + 7);
+
+  auto extra = movable(8);
+  l.push_back(extra);
+  EXPECT_EQ(&l.back(), &extra);
+  EXPECT_EQ(std::distance(l.begin(), l.end()), 9);
+  l.clear();
+  for (auto i = 0; i < 8; i++) { first[i].~movable(); }
+}
+
+TEST(intrusive_forward_list, iterator_to) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  EXPECT_EQ(l.iterator_to(fs[0]), l.begin());
+  EXPECT_EQ(&*l.iterator_to(fs[3]), &fs[3]);
+  EXPECT_EQ(list_type::s_iterator_to(fs[7]), std::next(l.begin(), 7));
+  auto const& cl = l;
+  EXPECT_EQ(cl.iterator_to(std::as_const(fs[5])), std::next(cl.begin(), 5));
+  EXPECT_EQ(list_type::s_iterator_to(std::as_const(fs[2])), std::next(cl.begin(), 2));
+}
+
+TEST(intrusive_forward_list, previous) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  EXPECT_EQ(l.previous(l.begin()), l.before_begin());
+  EXPECT_EQ(l.previous(l.iterator_to(fs[4])), l.iterator_to(fs[3]));
+  EXPECT_EQ(l.previous(l.end()), l.iterator_to(fs[7]));
+  auto const& cl = l;
+  EXPECT_EQ(cl.previous(cl.iterator_to(fs[1])), cl.begin());
+
+  l.erase_after(l.previous(l.iterator_to(fs[4])));
+  l.erase_after(l.previous(l.iterator_to(fs[0])));
+  auto expected = std::vector<std::reference_wrapper<foo>>{fs[1], fs[2], fs[3], fs[5], fs[6], fs[7]};
+  check_equal_range(l, expected);
+  auto empty = list_type();
+  EXPECT_EQ(empty.previous(empty.end()), empty.before_begin());
+}
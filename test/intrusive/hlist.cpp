@@ -0,0 +1,224 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/hlist.hpp"
+
+#include <functional>
+#include <list>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static_assert(std::is_trivially_default_constructible_v<pleione::intrusive::hlist_hook>);
+static_assert(sizeof(pleione::intrusive::hlist_hook) == 2 * sizeof(void*));
+
+struct foo {
+  int value;
+  pleione::intrusive::hlist_hook hook;
+
+  friend bool operator==(foo const& a, foo const& b) noexcept { return &a == &b; }
+};
+
+using list_type = pleione::intrusive::hlist<foo, &foo::hook>;
+
+static_assert(sizeof(list_type) == sizeof(void*));
+
+template<typename List, typename ForwardIt>
+static void check_equal_range(List& actual, ForwardIt first, ForwardIt last) {
+  EXPECT_EQ(actual.empty(), std::distance(first, last) == 0);
+  EXPECT_EQ(actual.size(), std::distance(first, last));
+  EXPECT_TRUE(std::equal(actual.begin(), actual.end(), first, last));
+  if (first != last) { EXPECT_EQ(actual.front(), *first); }
+}
+
+template<typename List, typename Range> static void check_equal_range(List& actual, Range&& range) {
+  check_equal_range(actual, range.begin(), range.end());
+}
+
+template<typename List> static void check_empty(List& actual) {
+  EXPECT_TRUE(actual.empty());
+  EXPECT_EQ(actual.size(), 0);
+  EXPECT_EQ(actual.begin(), actual.end());
+}
+
+TEST(intrusive_hlist, default_constructor) {
+  auto l = list_type();
+  check_empty(l);
+}
+
+TEST(intrusive_hlist, range_constructor) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  check_equal_range(l, fs);
+
+  auto empty = list_type(fs.end(), fs.end());
+  check_empty(empty);
+}
+
+TEST(intrusive_hlist, move) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  auto l2 = std::move(l);
+  check_empty(l);
+  check_equal_range(l2, fs);
+
+  l = std::move(l2);
+  check_empty(l2);
+  l.erase(fs[0]);
+  check_equal_range(l, std::vector<std::reference_wrapper<foo>>(fs.begin() + 1, fs.end()));
+  l.push_front(fs[0]);
+  check_equal_range(l, fs);
+
+  auto& self = l;
+  l = std::move(self);
+  check_equal_range(l, fs);
+  l.erase(fs[0]);
+  check_equal_range(l, std::vector<std::reference_wrapper<foo>>(fs.begin() + 1, fs.end()));
+}
+
+TEST(intrusive_hlist, push_pop) {
+  auto fs = std::vector<foo>(4);
+  auto l = list_type();
+  for (auto it = fs.rbegin(); it != fs.rend(); ++it) { l.push_front(*it); }
+  check_equal_range(l, fs);
+  l.pop_front();
+  check_equal_range(l, std::vector<std::reference_wrapper<foo>>(fs.begin() + 1, fs.end()));
+  l.pop_front();
+  l.pop_front();
+  l.pop_front();
+  check_empty(l);
+}
+
+TEST(intrusive_hlist, insert_erase) {
+  auto fs = std::vector<foo>(6);
+  auto l = list_type();
+  l.push_front(fs[2]);
+  l.insert(l.begin(), fs[0]);
+  l.insert_after(l.begin(), fs[1]);
+  l.insert_after(l.iterator_to(fs[2]), fs[4]);
+  l.insert(l.iterator_to(fs[4]), fs[3]);
+  l.insert_after(l.iterator_to(fs[4]), fs[5]);
+  check_equal_range(l, fs);
+
+  EXPECT_EQ(l.erase(fs[3]), l.iterator_to(fs[4]));
+  EXPECT_EQ(l.erase(fs[5]), l.end());
+  EXPECT_EQ(l.erase(l.begin()), l.iterator_to(fs[1]));
+  check_equal_range(l, std::vector<std::reference_wrapper<foo>>{fs[1], fs[2], fs[4]});
+  l.clear();
+  check_empty(l);
+}
+
+TEST(intrusive_hlist, iterators) {
+  auto fs = std::vector<foo>(4);
+  auto l = list_type(fs.begin(), fs.end());
+  auto const& cl = l;
+  EXPECT_EQ(list_type::s_iterator_to(fs[2]), std::next(l.begin(), 2));
+  EXPECT_EQ(cl.iterator_to(std::as_const(fs[3])), std::next(cl.begin(), 3));
+  list_type::const_iterator it = l.begin();
+  EXPECT_EQ(it, cl.begin());
+  EXPECT_EQ(&*it++, &fs[0]);
+  EXPECT_EQ(&*it, &fs[1]);
+}
+
+TEST(intrusive_hlist, buckets) {
+  auto fs = std::vector<foo>(64);
+  auto buckets = std::vector<list_type>(8);
+  for (auto i = 0; i < 64; i++) {
+    fs[i].value = i;
+    buckets[i % 8].push_front(fs[i]);
+  }
+  for (auto i = 0; i < 64; i += 3) { buckets[i % 8].erase(fs[i]); }
+  for (auto b = 0; b < 8; b++) {
+    auto expected = std::vector<int>();
+    for (auto i = 56 + b; i >= 0; i -= 8) {
+      if (i % 3) { expected.emplace_back(i); }
+    }
+    auto actual = std::vector<int>();
+    for (auto& f : buckets[b]) { actual.emplace_back(f.value); }
+    EXPECT_EQ(actual, expected);
+  }
+}
+
+TEST(intrusive_hlist, algorithms) {
+  auto fs = std::vector<foo>(100);
+  for (auto i = 0; i < 100; i++) { fs[i].value = i; }
+  auto l = list_type(fs.begin(), fs.end());
+
+  auto sum = 0;
+  for_each(l.begin(), l.end(), [&](foo& f) { sum += f.value; });
+  EXPECT_EQ(sum, 4950);
+  sum = 0;
+  for_each(pleione::prefetch<4>::members<&foo::value>{}, l.begin(), l.end(), [&](foo& f) { sum += f.value; });
+  EXPECT_EQ(sum, 4950);
+
+  auto const& cl = l;
+  EXPECT_EQ(transform_reduce(cl.begin(), cl.end(), 0, std::plus<>{}, [](foo const& f) { return f.value; }), 4950);
+  EXPECT_EQ(transform_reduce(pleione::prefetch<false>{}, l.begin(), l.end(), 0, std::plus<>{},
+                             [](foo const& f) { return f.value; }),
+            4950);
+
+  auto it = find_if(l.begin(), l.end(), [](foo const& f) { return f.value == 42; });
+  EXPECT_EQ(&*it, &fs[42]);
+  EXPECT_EQ(find_if(pleione::prefetch<2>{}, l.begin(), l.end(), [](foo const&) { return false; }), l.end());
+}
+
+TEST(intrusive_hlist, random_operations) {
+  auto fs = std::vector<foo>(64);
+  auto l = list_type();
+  auto expected = std::list<std::reference_wrapper<foo>>();
+  auto unlinked = std::vector<foo*>();
+  for (auto& f : fs) { unlinked.emplace_back(&f); }
+
+  auto eng = std::default_random_engine(0);
+  for (auto step = 0; step < 10000; step++) {
+    auto operation = std::uniform_int_distribution<int>(0, 4)(eng);
+    auto position = std::uniform_int_distribution<size_t>(0, expected.size())(eng);
+    if (operation < 3 && !unlinked.empty()) {
+      auto& f = *unlinked.back();
+      unlinked.pop_back();
+      if (operation == 0 || expected.empty()) {
+        l.push_front(f);
+        expected.emplace_front(f);
+      } else if (operation == 1) {
+        position = std::min(position, expected.size() - 1);
+        l.insert(std::next(l.begin(), position), f);
+        expected.insert(std::next(expected.begin(), position), f);
+      } else {
+        position = std::min(position, expected.size() - 1);
+        l.insert_after(std::next(l.begin(), position), f);
+        expected.insert(std::next(expected.begin(), position + 1), f);
+      }
+    } else if (!expected.empty()) {
+      position = std::min(position, expected.size() - 1);
+      auto& f = *std::next(l.begin(), position);
+      unlinked.emplace_back(&f);
+      l.erase(f);
+      expected.erase(std::next(expected.begin(), position));
+    }
+    ASSERT_EQ(l.size(), expected.size());
+  }
+  check_equal_range(l, expected);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/interleaved.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+struct foo {
+  int value = 0;
+  pleione::intrusive::list_hook hook;
+  pleione::intrusive::forward_list_hook forward_hook;
+};
+
+using list_type = pleione::intrusive::list<foo, &foo::hook>;
+using forward_list_type = pleione::intrusive::forward_list<foo, &foo::forward_hook>;
+
+// Distributes the elements randomly among the lists, some of which stay empty.
+template<typename List> static void fill(std::vector<List>& lists, std::vector<foo>& fs) {
+  auto eng = std::default_random_engine(fs.size());
+  auto dist = std::uniform_int_distribution<size_t>(0, lists.size() - 1);
+  for (auto idx = 0u; idx < fs.size(); idx++) {
+    fs[idx].value = idx;
+    lists[dist(eng)].push_front(fs[idx]);
+  }
+}
+
+template<size_t Width, typename List> static void check_interleaved(size_t lists_count, size_t n) {
+  auto fs = std::vector<foo>(n);
+  auto lists = std::vector<List>(lists_count);
+  fill(lists, fs);
+
+  auto visited = std::vector<std::vector<int>>(lists_count);
+  auto owner = std::vector<size_t>(n);
+  for (auto idx = 0u; idx < lists_count; idx++) {
+    for (auto& f : lists[idx]) { owner[f.value] = idx; }
+  }
+  pleione::intrusive::for_each_interleaved<Width>(lists.begin(), lists.end(),
+                                                  [&](foo& f) { visited[owner[f.value]].emplace_back(f.value); });
+  for (auto idx = 0u; idx < lists_count; idx++) {
+    auto expected = std::vector<int>();
+    for (auto& f : lists[idx]) { expected.emplace_back(f.value); }
+    EXPECT_EQ(visited[idx], expected);
+  }
+
+  auto sum = pleione::intrusive::transform_reduce_interleaved<Width>(lists.begin(), lists.end(), 5, std::plus<>{},
+                                                                     [](foo const& f) { return f.value; });
+  EXPECT_EQ(sum, 5 + int(n * (n - 1) / 2));
+}
+
+TEST(intrusive_interleaved, empty) {
+  auto lists = std::vector<list_type>();
+  auto count = 0;
+  pleione::intrusive::for_each_interleaved(lists.begin(), lists.end(), [&](foo&) { count++; });
+  EXPECT_EQ(count, 0);
+
+  lists.resize(4);
+  pleione::intrusive::for_each_interleaved(lists.begin(), lists.end(), [&](foo&) { count++; });
+  EXPECT_EQ(count, 0);
+}
+
+TEST(intrusive_interleaved, list) {
+  for (auto lists : {1u, 3u, 8u, 9u, 100u}) {
+    for (auto n : {0u, 1u, 7u, 64u, 1000u}) {
+      check_interleaved<1, list_type>(lists, n);
+      check_interleaved<4, list_type>(lists, n);
+      check_interleaved<8, list_type>(lists, n);
+      check_interleaved<32, list_type>(lists, n);
+    }
+  }
+}
+
+TEST(intrusive_interleaved, forward_list) {
+  for (auto lists : {1u, 3u, 8u, 9u, 100u}) {
+    for (auto n : {0u, 1u, 7u, 64u, 1000u}) {
+      check_interleaved<1, forward_list_type>(lists, n);
+      check_interleaved<4, forward_list_type>(lists, n);
+      check_interleaved<8, forward_list_type>(lists, n);
+      check_interleaved<32, forward_list_type>(lists, n);
+    }
+  }
+}
+
+// The elements of each list are visited in order, so the visited one is
+// always at the front and can be unlinked.
+TEST(intrusive_interleaved, erase_visited) {
+  auto fs = std::vector<foo>(500);
+  auto lists = std::vector<list_type>(20);
+  fill(lists, fs);
+  auto owner = std::vector<list_type*>(fs.size());
+  for (auto& l : lists) {
+    for (auto& f : l) { owner[f.value] = &l; }
+  }
+
+  auto count = 0u;
+  pleione::intrusive::for_each_interleaved<4>(lists.begin(), lists.end(), [&](foo& f) {
+    EXPECT_EQ(&owner[f.value]->front(), &f);
+    owner[f.value]->pop_front();
+    count++;
+  });
+  EXPECT_EQ(count, fs.size());
+  EXPECT_TRUE(std::all_of(lists.begin(), lists.end(), [](list_type const& l) { return l.empty(); }));
+}
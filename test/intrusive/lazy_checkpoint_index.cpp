@@ -0,0 +1,185 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/lazy_checkpoint_index.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+struct foo {
+  int value = 0;
+  pleione::intrusive::list_hook hook;
+};
+
+using list_type = pleione::intrusive::list<foo, &foo::hook, true, true>;
+using index_type = pleione::intrusive::lazy_checkpoint_index<list_type>;
+
+static std::vector<int> visit(index_type& index) {
+  auto visited = std::vector<int>();
+  for_each(index, [&](foo& f) { visited.emplace_back(f.value); });
+  std::sort(visited.begin(), visited.end());
+  return visited;
+}
+
+static std::vector<int> values(list_type& list) {
+  auto result = std::vector<int>();
+  for (auto& f : list) { result.emplace_back(f.value); }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+TEST(intrusive_lazy_checkpoint_index, generation) {
+  auto fs = std::vector<foo>(4);
+  auto l = list_type();
+  auto generation = l.generation();
+  l.push_back(fs[0]);
+  EXPECT_NE(l.generation(), generation);
+  generation = l.generation();
+  l.insert(l.begin(), fs.begin() + 1, fs.end());
+  EXPECT_NE(l.generation(), generation);
+  generation = l.generation();
+  l.erase(l.begin());
+  EXPECT_NE(l.generation(), generation);
+
+  auto l2 = list_type();
+  generation = l.generation();
+  auto generation2 = l2.generation();
+  l2.splice(l2.end(), l, l.begin(), std::next(l.begin()));
+  EXPECT_NE(l.generation(), generation);
+  EXPECT_NE(l2.generation(), generation2);
+
+  auto gs = std::vector<foo>(3);
+  for (auto overload = 0; overload < 3; overload++) {
+    auto source = list_type(gs.begin(), gs.end());
+    auto target = list_type();
+    auto source_generation = source.generation();
+    if (overload == 0) {
+      target.splice(target.end(), std::move(source));
+    } else if (overload == 1) {
+      target.splice(target.end(), std::move(source), source.begin());
+    } else {
+      target.splice(target.end(), std::move(source), source.begin(), source.end());
+    }
+    EXPECT_NE(source.generation(), source_generation);
+    target.clear();
+  }
+
+  generation = l.generation();
+  l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+  EXPECT_NE(l.generation(), generation);
+  generation = l.generation();
+  l.clear();
+  EXPECT_NE(l.generation(), generation);
+}
+
+TEST(intrusive_lazy_checkpoint_index, segments) {
+  auto fs = std::vector<foo>(100);
+  auto l = list_type(fs.begin(), fs.end());
+  auto index = index_type(l, 16);
+  EXPECT_FALSE(index.valid());
+  index.update();
+  EXPECT_TRUE(index.valid());
+  EXPECT_EQ(index.segments(), 7);
+  for (auto i = 0u; i < index.segments(); i++) {
+    EXPECT_EQ(&*index.segment_begin(i), &fs[i * 16]);
+    if (i + 1 < index.segments()) {
+      EXPECT_EQ(&*index.segment_end(i), &fs[(i + 1) * 16]);
+    } else {
+      EXPECT_EQ(index.segment_end(i), l.end());
+    }
+  }
+
+  l.pop_front();
+  EXPECT_FALSE(index.valid());
+  index.update();
+  EXPECT_TRUE(index.valid());
+  EXPECT_EQ(&*index.segment_begin(0), &fs[1]);
+}
+
+TEST(intrusive_lazy_checkpoint_index, empty) {
+  auto l = list_type();
+  auto index = index_type(l);
+  EXPECT_TRUE(visit(index).empty());
+  EXPECT_EQ(index.segments(), 0);
+  EXPECT_EQ(transform_reduce(index, 7, std::plus<>{}, [](foo const&) { return 1; }), 7);
+}
+
+template<std::size_t Cursors> static void check_traversal(size_t n, size_t stride) {
+  auto fs = std::vector<foo>(n);
+  auto order = std::vector<int>(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::default_random_engine(n));
+  auto l = list_type();
+  for (auto idx : order) {
+    fs[idx].value = idx;
+    l.push_back(fs[idx]);
+  }
+
+  auto index = index_type(l, stride);
+  auto expected = std::vector<int>(n);
+  std::iota(expected.begin(), expected.end(), 0);
+
+  auto visited = std::vector<int>();
+  pleione::intrusive::for_each<Cursors>(index, [&](foo& f) { visited.emplace_back(f.value); });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, expected);
+
+  auto sum =
+      pleione::intrusive::transform_reduce<Cursors>(index, 3, std::plus<>{}, [](foo const& f) { return f.value; });
+  EXPECT_EQ(sum, 3 + int(n * (n - 1) / 2));
+}
+
+TEST(intrusive_lazy_checkpoint_index, traversal) {
+  for (auto n : {1u, 2u, 15u, 16u, 17u, 100u, 1000u}) {
+    for (auto stride : {1u, 3u, 16u, 64u, 2000u}) {
+      check_traversal<1>(n, stride);
+      check_traversal<2>(n, stride);
+      check_traversal<8>(n, stride);
+      check_traversal<16>(n, stride);
+    }
+  }
+}
+
+TEST(intrusive_lazy_checkpoint_index, lazy_update) {
+  auto fs = std::vector<foo>(64);
+  for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = idx; }
+  auto l = list_type(fs.begin(), fs.end());
+  auto index = index_type(l, 4);
+  EXPECT_EQ(visit(index), values(l));
+
+  l.erase(std::next(l.begin(), 10), std::next(l.begin(), 30));
+  EXPECT_FALSE(index.valid());
+  EXPECT_EQ(visit(index), values(l));
+  EXPECT_TRUE(index.valid());
+
+  auto extra = foo();
+  extra.value = 100;
+  l.push_back(extra);
+  EXPECT_EQ(visit(index), values(l));
+  EXPECT_EQ(transform_reduce(index, 0, std::plus<>{}, [](foo const&) { return 1; }), 45);
+}
@@ -21,10 +21,19 @@
  */
 
 #include "pleione/intrusive/list.hpp"
+#include "pleione/parallel.hpp"
 
 #include <array>
+#include <atomic>
+#include <functional>
 #include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -40,8 +49,13 @@ struct foo {
 };
 
 using list_type = pleione::intrusive::list<foo, &foo::hook>;
+using sizeless_list_type = pleione::intrusive::list<foo, &foo::hook, false>;
 
-template<typename ForwardIt> static void check_equal_range(list_type& actual, ForwardIt first, ForwardIt last) {
+static_assert(sizeof(sizeless_list_type) == 2 * sizeof(void*));
+static_assert(sizeof(list_type) == sizeof(sizeless_list_type) + sizeof(size_t));
+
+template<typename List, typename ForwardIt>
+static void check_equal_range(List& actual, ForwardIt first, ForwardIt last) {
   EXPECT_EQ(actual.empty(), std::distance(first, last) == 0);
   EXPECT_EQ(actual.size(), std::distance(first, last));
   EXPECT_TRUE(std::equal(actual.begin(), actual.end(), first, last));
@@ -53,11 +67,11 @@ template<typename ForwardIt> static void check_equal_range(list_type& actual, Fo
   }
 }
 
-template<typename Range> static void check_equal_range(list_type& actual, Range&& range) {
+template<typename List, typename Range> static void check_equal_range(List& actual, Range&& range) {
   check_equal_range(actual, range.begin(), range.end());
 }
 
-static void check_empty(list_type& actual) {
+template<typename List> static void check_empty(List& actual) {
   EXPECT_TRUE(actual.empty());
   EXPECT_EQ(actual.size(), 0);
   EXPECT_EQ(actual.begin(), actual.end());
@@ -85,7 +99,7 @@ TEST(intrusive_list, move_constructor) {
   auto fs = std::vector<foo>(8);
   auto l = list_type(fs.begin(), fs.end());
   auto l2 = std::move(l);
-  l.clear();
+  check_empty(l);
   check_equal_range(l2, fs);
 }
 
@@ -692,18 +706,19 @@ struct object {
   size_t value;
 
   friend bool operator==(object const& a, object const& b) noexcept { return a.value == b.value; }
+  friend bool operator<(object const& a, object const& b) noexcept { return a.value < b.value; }
 };
 
 size_t value_counter = 0;
 
-struct state {
+template<bool ConstantTimeSize> struct basic_state {
   std::list<object> std_;
-  pleione::intrusive::list<object, &object::hook> pln_;
+  pleione::intrusive::list<object, &object::hook, ConstantTimeSize> pln_;
 
 public:
-  state() = default;
-  state(state&&) = default;
-  state(state const& other) {
+  basic_state() = default;
+  basic_state(basic_state&&) = default;
+  basic_state(basic_state const& other) {
     for (auto& obj : other.std_) {
       auto& nobj = std_.emplace_back();
       nobj.value = obj.value;
@@ -779,65 +794,77 @@ public:
 
   bool check_bounds() const { return std_.size() < 8; }
 
-  friend bool operator==(state const& a, state const& b) noexcept { return a.std_.size() == b.std_.size(); }
+  friend bool operator==(basic_state const& a, basic_state const& b) noexcept {
+    return a.std_.size() == b.std_.size();
+  }
 };
 
 namespace std {
 
-template<> struct hash<::state> {
-  size_t operator()(state const& st) const noexcept { return st.size(); }
+template<bool ConstantTimeSize> struct hash<::basic_state<ConstantTimeSize>> {
+  size_t operator()(::basic_state<ConstantTimeSize> const& st) const noexcept { return st.size(); }
 };
 
 } // namespace std
 
+template<bool ConstantTimeSize> static void walk_states() {
+  using state = basic_state<ConstantTimeSize>;
+  state_walk<state>(
+      {
+          [](state const& in) {
+            std::vector<state> out;
+            out.emplace_back(in).push_front();
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            out.emplace_back(in).push_back();
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            if (!in.empty()) { out.emplace_back(in).pop_front(); }
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            if (!in.empty()) { out.emplace_back(in).pop_back(); }
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            for (auto i = 0u; i <= in.size(); i++) { out.emplace_back(in).insert(i); }
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            for (auto i = 0u; i < in.size(); i++) {
+              for (auto j = 0u; j < 16; j++) { out.emplace_back(in).insert(i, j); }
+            }
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            for (auto i = 0u; i < in.size(); i++) { out.emplace_back(in).erase(i); }
+            return out;
+          },
+          [](state const& in) {
+            std::vector<state> out;
+            for (auto i = 0u; i < in.size(); i++) {
+              for (auto j = 0u; j <= in.size() - i; j++) { out.emplace_back(in).erase(i, i + j); }
+            }
+            return out;
+          },
+      },
+      std::mem_fn(&state::validate), std::mem_fn(&state::check_bounds));
+}
+
 TEST(intrusive_list, state_walk) {
-  state_walk<state>({
-                        [](state const& in) {
-                          std::vector<state> out;
-                          out.emplace_back(in).push_front();
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          out.emplace_back(in).push_back();
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          if (!in.empty()) { out.emplace_back(in).pop_front(); }
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          if (!in.empty()) { out.emplace_back(in).pop_back(); }
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          for (auto i = 0u; i <= in.size(); i++) { out.emplace_back(in).insert(i); }
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          for (auto i = 0u; i < in.size(); i++) {
-                            for (auto j = 0u; j < 16; j++) { out.emplace_back(in).insert(i, j); }
-                          }
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          for (auto i = 0u; i < in.size(); i++) { out.emplace_back(in).erase(i); }
-                          return out;
-                        },
-                        [](state const& in) {
-                          std::vector<state> out;
-                          for (auto i = 0u; i < in.size(); i++) {
-                            for (auto j = 0u; j <= in.size() - i; j++) { out.emplace_back(in).erase(i, i + j); }
-                          }
-                          return out;
-                        },
-                    },
-                    std::mem_fn(&state::validate), std::mem_fn(&state::check_bounds));
+  walk_states<true>();
+}
+
+TEST(intrusive_list, sizeless_state_walk) {
+  walk_states<false>();
 }
 
 TEST(intrusive_list, for_each) {
@@ -918,3 +945,378 @@ TEST(intrusive_list, transform_reduce) {
     EXPECT_EQ(value, 65536);
   }
 }
+
+TEST(intrusive_list, find_count) {
+  auto fs = std::vector<foo>(16);
+  for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = idx; }
+  auto const l = list_type(fs.begin(), fs.end());
+
+  auto it = find_if(l.begin(), l.end(), [](foo const& object) { return object.value == 5; });
+  EXPECT_EQ(&*it, &fs[5]);
+  EXPECT_EQ(find_if(l.begin(), l.end(), [](foo const& object) { return object.value == 16; }), l.end());
+  EXPECT_TRUE(any_of(l.begin(), l.end(), [](foo const& object) { return object.value == 15; }));
+  EXPECT_FALSE(any_of(l.begin(), l.end(), [](foo const& object) { return object.value < 0; }));
+  EXPECT_TRUE(all_of(l.begin(), l.end(), [](foo const& object) { return object.value < 16; }));
+  EXPECT_FALSE(all_of(l.begin(), l.end(), [](foo const& object) { return object.value < 15; }));
+  EXPECT_TRUE(none_of(l.begin(), l.end(), [](foo const& object) { return object.value > 15; }));
+  EXPECT_EQ(count_if(l.begin(), l.end(), [](foo const& object) { return object.value % 2; }), 8);
+  EXPECT_EQ(count_if(l.end(), l.end(), [](foo const&) { return true; }), 0);
+}
+
+TEST(intrusive_list, parallel) {
+  for (auto n : {0u, 1u, 255u, 256u, 257u, 1000u, 10000u}) {
+    auto fs = std::vector<foo>(n);
+    for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = 0; }
+    auto l = list_type(fs.begin(), fs.end());
+    for (auto threads : {0u, 1u, 3u, 64u}) {
+      for_each(pleione::parallel{threads}, l.begin(), l.end(), [](foo& object) { object.value++; });
+      EXPECT_TRUE(std::all_of(fs.begin(), fs.end(), [](foo const& object) { return object.value == 1; }));
+      auto value = transform_reduce(pleione::parallel{threads}, l.begin(), l.end(), 4, std::plus<>{},
+                                    [](foo& object) { return object.value--; });
+      EXPECT_EQ(value, 4 + int(n));
+      EXPECT_TRUE(std::all_of(fs.begin(), fs.end(), [](foo const& object) { return object.value == 0; }));
+    }
+  }
+}
+
+TEST(intrusive_list, parallel_exception) {
+  auto fs = std::vector<foo>(10000);
+  auto l = list_type(fs.begin(), fs.end());
+  for (auto thrower : {0u, 5000u, 9999u}) {
+    for (auto threads : {1u, 4u}) {
+      auto visited = std::atomic<unsigned>(0);
+      auto fn = [&](foo& object) {
+        if (&object == &fs[thrower]) { throw std::runtime_error("parallel"); }
+        visited++;
+        return 1;
+      };
+      EXPECT_THROW(for_each(pleione::parallel{threads}, l.begin(), l.end(), fn), std::runtime_error);
+      EXPECT_LT(visited.load(), fs.size());
+      EXPECT_THROW(transform_reduce(pleione::parallel{threads}, l.begin(), l.end(), 0, std::plus<>{}, fn),
+                   std::runtime_error);
+    }
+  }
+}
+
+template<typename Prefetch> static void check_prefetch_depth(Prefetch pf) {
+  for (auto n = 0u; n < 20; n++) {
+    auto fs = std::vector<foo>(n);
+    for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = idx; }
+    auto l = list_type(fs.begin(), fs.end());
+
+    auto visited = std::vector<int>();
+    for_each(pf, l.begin(), l.end(), [&](auto const& object) { visited.emplace_back(object.value); });
+    auto expected = std::vector<int>(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(visited, expected);
+
+    for (auto target = 0u; target <= n; target++) {
+      auto it = find_if(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) == target; });
+      if (target < n) {
+        EXPECT_EQ(&*it, &fs[target]);
+      } else {
+        EXPECT_EQ(it, l.end());
+      }
+      EXPECT_EQ(any_of(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) == target; }),
+                target < n);
+    }
+    EXPECT_EQ(any_of(pf, l.begin(), l.end(), [&](auto const& object) { return object.value == int(n / 2); }), n > 0);
+    EXPECT_TRUE(all_of(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) < n; }));
+    EXPECT_EQ(all_of(pf, l.begin(), l.end(), [](auto const& object) { return object.value % 2 == 0; }), n < 2);
+    EXPECT_TRUE(none_of(pf, l.begin(), l.end(), [&](auto const& object) { return unsigned(object.value) >= n; }));
+    EXPECT_EQ(count_if(pf, l.begin(), l.end(), [](auto const& object) { return object.value % 3 == 0; }),
+              (n + 2) / 3);
+
+    auto value = transform_reduce(pf, l.begin(), l.end(), 4, std::plus<>{}, [](auto const& object) {
+      return object.value;
+    });
+    EXPECT_EQ(value, 4 + int(n * (n - 1) / 2));
+  }
+}
+
+TEST(intrusive_list, prefetch_depth) {
+  check_prefetch_depth(pleione::prefetch<0>{});
+  check_prefetch_depth(pleione::prefetch<1, pleione::locality::low>{});
+  check_prefetch_depth(pleione::prefetch<2>{});
+  check_prefetch_depth(pleione::prefetch<3, pleione::locality::moderate, true>{});
+  check_prefetch_depth(pleione::prefetch<4, pleione::locality::nta>{});
+  check_prefetch_depth(pleione::prefetch<16>{});
+}
+
+TEST(intrusive_list, prefetch_members) {
+  check_prefetch_depth(pleione::prefetch<0>::members<&foo::value>{});
+  check_prefetch_depth(pleione::prefetch<1>::members<&foo::value>{});
+  check_prefetch_depth(pleione::prefetch<4, pleione::locality::nta>::members<&foo::value, &foo::hook>{});
+  check_prefetch_depth(pleione::prefetch<1, pleione::locality::low, true>::object{});
+  check_prefetch_depth(pleione::prefetch<8>::object{});
+}
+
+TEST(intrusive_list, sort) {
+  for (auto n : {0, 1, 2, 3, 7, 64, 1000}) {
+    auto fs = std::vector<foo>(n);
+    auto eng = std::default_random_engine(n);
+    auto dist = std::uniform_int_distribution<int>(0, n / 4);
+    for (auto& f : fs) { f.value = dist(eng); }
+    auto expected = std::vector<foo*>(n);
+    std::transform(fs.begin(), fs.end(), expected.begin(), [](foo& f) { return &f; });
+    std::stable_sort(expected.begin(), expected.end(), [](foo* a, foo* b) { return a->value < b->value; });
+
+    auto l = list_type(fs.begin(), fs.end());
+    l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+    EXPECT_EQ(l.size(), n);
+    auto same = [](foo const& a, foo const* b) { return &a == b; };
+    EXPECT_TRUE(std::equal(l.begin(), l.end(), expected.begin(), expected.end(), same));
+    EXPECT_TRUE(std::equal(l.rbegin(), l.rend(), expected.rbegin(), expected.rend(), same));
+  }
+}
+
+TEST(intrusive_list, sort_default_compare) {
+  auto fs = std::vector<object>(16);
+  for (auto idx = 0u; idx < fs.size(); idx++) { fs[idx].value = (idx * 7) % fs.size(); }
+  auto l = pleione::intrusive::list<object, &object::hook>(fs.begin(), fs.end());
+  l.sort();
+  auto value = size_t(0);
+  for (auto& obj : l) { EXPECT_EQ(obj.value, value++); }
+  EXPECT_EQ(value, fs.size());
+}
+
+TEST(intrusive_list, sizeless_splice_range) {
+  for (auto idx = 0; idx <= 8; ++idx) {
+    for (auto jdx = 0; jdx <= 8; ++jdx) {
+      for (auto n = 0; n <= 8 - jdx; ++n) {
+        auto fa = std::list<foo>(8);
+        auto fb = std::list<foo>(8);
+        auto la = sizeless_list_type(fa.begin(), fa.end());
+        auto lb = sizeless_list_type(fb.begin(), fb.end());
+        auto it_b = std::next(lb.begin(), jdx);
+        la.splice(std::next(la.begin(), idx), lb, it_b, std::next(it_b, n));
+        auto f_it_b = std::next(fb.begin(), jdx);
+        fa.splice(std::next(fa.begin(), idx), fb, f_it_b, std::next(f_it_b, n));
+        check_equal_range(la, fa);
+        check_equal_range(lb, fb);
+      }
+    }
+  }
+}
+
+TEST(intrusive_list, sizeless_splice_all) {
+  auto fa = std::list<foo>(4);
+  auto fb = std::list<foo>(4);
+  auto la = sizeless_list_type(fa.begin(), fa.end());
+  auto lb = sizeless_list_type(fb.begin(), fb.end());
+  la.splice(std::next(la.begin(), 2), lb);
+  fa.splice(std::next(fa.begin(), 2), fb);
+  check_equal_range(la, fa);
+  check_empty(lb);
+
+  auto lc = std::move(la);
+  check_equal_range(lc, fa);
+  lc.erase(std::next(lc.begin()), std::prev(lc.end()));
+  fa.erase(std::next(fa.begin()), std::prev(fa.end()));
+  check_equal_range(lc, fa);
+  lc.clear();
+  check_empty(lc);
+}
+
+struct movable {
+  int value = 0;
+  pleione::intrusive::list_hook hook;
+
+  explicit movable(int v) noexcept : value(v) {}
+  movable(movable&& other) noexcept : value(other.value) {}
+};
+
+TEST(intrusive_list, relinearize) {
+  using storage_type = std::aligned_storage_t<sizeof(movable), alignof(movable)>;
+  for (auto n = 0; n < 20; n++) {
+    auto source = std::make_unique<storage_type[]>(n);
+    auto destination = std::make_unique<storage_type[]>(n);
+    auto order = std::vector<int>(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(n));
+
+    auto l = pleione::intrusive::list<movable, &movable::hook>();
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      l.push_front(*::new (static_cast<void*>(&source[*it])) movable(*it));
+    }
+
+    auto first = reinterpret_cast<movable*>(destination.get());
+    EXPECT_EQ(l.relinearize(first), first + n);
+
+    auto idx = 0;
+    for (auto& object : l) {
+      EXPECT_EQ(&object, first + idx);
+      EXPECT_EQ(object.value, order[idx]);
+      idx++;
+    }
+    EXPECT_EQ(idx, n);
+
+    l.clear();
+    for (auto i = 0; i < n; i++) { first[i].~movable(); }
+  }
+}
+
+TEST(intrusive_list, relinearize_custom_relocate) {
+  using storage_type = std::aligned_storage_t<sizeof(movable), alignof(movable)>;
+  auto source = std::vector<std::unique_ptr<movable>>();
+  auto l = pleione::intrusive::list<movable, &movable::hook>();
+  for (auto i = 0; i < 8; i++) { l.push_front(*source.emplace_back(std::make_unique<movable>(i))); }
+
+  auto destination = std::make_unique<storage_type[]>(8);
+  auto relocated = 0;
+  auto last = l.relinearize(reinterpret_cast<movable*>(destination.get()), [&](movable& from, void* to) -> movable& {
+    relocated++;
+    return *::new (to) movable(std::move(from));
+  });
+  EXPECT_EQ(relocated, 8);
+  EXPECT_EQ(last, reinterpret_cast<movable*>(destination.get()) + 8);
+  EXPECT_TRUE(std::equal(l.begin(), l.end(), source.rbegin(), source.rend(),
+                         [](movable const& a, std::unique_ptr<movable> const& b) { return a.value == b->value; }));
+}
+
+struct task {
+  virtual ~task() = default;
+  virtual int run() const = 0;
+  pleione::intrusive::list_hook hook;
+};
+
+struct constant_task : task {
+  int value = 0;
+
+  explicit constant_task(int v) noexcept : value(v) {}
+  int run() const override { return value; }
+};
+
+TEST(intrusive_list, abstract_element) {
+  auto a = constant_task(1);
+  auto b = constant_task(2);
+  auto l = pleione::intrusive::list<task, &task::hook>();
+  l.push_back(a);
+  l.push_back(b);
+  EXPECT_EQ(l.front().run(), 1);
+  EXPECT_EQ(l.back().run(), 2);
+  auto sum = 0;
+  for_each(l.begin(), l.end(), [&](task const& t) { sum += t.run(); });
+  EXPECT_EQ(sum, 3);
+  l.clear();
+}
+
+struct large_element {
+  char padding[300000];
+  pleione::intrusive::list_hook hook;
+  int value = 0;
+};
+
+TEST(intrusive_list, large_element) {
+  auto es = std::vector<large_element>(3);
+  for (auto idx = 0u; idx < es.size(); idx++) { es[idx].value = idx; }
+  auto l = pleione::intrusive::list<large_element, &large_element::hook>(es.begin(), es.end());
+  auto visited = std::vector<int>();
+  for_each(l.begin(), l.end(), [&](large_element const& e) { visited.emplace_back(e.value); });
+  EXPECT_EQ(visited, (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(&l.back(), &es[2]);
+}
+
+TEST(intrusive_list, iterator_to) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  EXPECT_EQ(l.iterator_to(fs[0]), l.begin());
+  EXPECT_EQ(&*l.iterator_to(fs[3]), &fs[3]);
+  EXPECT_EQ(list_type::s_iterator_to(fs[7]), std::prev(l.end()));
+  auto const& cl = l;
+  EXPECT_EQ(cl.iterator_to(std::as_const(fs[5])), std::next(cl.begin(), 5));
+  EXPECT_EQ(list_type::s_iterator_to(std::as_const(fs[2])), std::next(cl.begin(), 2));
+
+  EXPECT_EQ(l.erase(fs[3]), l.iterator_to(fs[4]));
+  l.erase(fs[0]);
+  l.erase(fs[7]);
+  auto expected = std::vector<std::reference_wrapper<foo>>{fs[1], fs[2], fs[4], fs[5], fs[6]};
+  check_equal_range(l, expected);
+}
+
+struct unlinking {
+  int value = 0;
+  pleione::intrusive::auto_unlink_list_hook hook;
+  pleione::intrusive::auto_unlink_list_hook other_hook;
+};
+
+using auto_unlink_list_type = pleione::intrusive::list<unlinking, &unlinking::hook, false>;
+using other_auto_unlink_list_type = pleione::intrusive::list<unlinking, &unlinking::other_hook, false>;
+
+template<typename List> static std::vector<int> values_of(List const& l) {
+  auto result = std::vector<int>();
+  for (auto& object : l) { result.emplace_back(object.value); }
+  return result;
+}
+
+TEST(intrusive_list, auto_unlink) {
+  auto a = auto_unlink_list_type();
+  auto b = other_auto_unlink_list_type();
+  auto objects = std::vector<std::unique_ptr<unlinking>>();
+  for (auto i = 0; i < 6; i++) {
+    auto& object = *objects.emplace_back(std::make_unique<unlinking>());
+    object.value = i;
+    a.push_back(object);
+    b.push_front(object);
+  }
+  EXPECT_TRUE(objects[0]->hook.is_linked());
+
+  objects[2].reset();
+  objects[0].reset();
+  EXPECT_EQ(values_of(a), (std::vector<int>{1, 3, 4, 5}));
+  EXPECT_EQ(values_of(b), (std::vector<int>{5, 4, 3, 1}));
+  EXPECT_EQ(a.size(), 4);
+
+  objects[5]->hook.unlink();
+  EXPECT_FALSE(objects[5]->hook.is_linked());
+  objects[5]->hook.unlink();
+  EXPECT_EQ(values_of(a), (std::vector<int>{1, 3, 4}));
+  EXPECT_EQ(&a.back(), objects[4].get());
+
+  a.erase(a.iterator_to(*objects[3]));
+  EXPECT_FALSE(objects[3]->hook.is_linked());
+  b.clear();
+  EXPECT_FALSE(objects[1]->other_hook.is_linked());
+  objects.clear();
+  EXPECT_TRUE(a.empty());
+}
+
+TEST(intrusive_list, auto_unlink_list_destroyed_first) {
+  auto objects = std::vector<std::unique_ptr<unlinking>>();
+  {
+    auto l = auto_unlink_list_type();
+    for (auto i = 0; i < 4; i++) { l.push_back(*objects.emplace_back(std::make_unique<unlinking>())); }
+    auto moved = std::move(l);
+    EXPECT_TRUE(l.empty());
+    EXPECT_EQ(moved.size(), 4);
+  }
+  for (auto& object : objects) { EXPECT_FALSE(object->hook.is_linked()); }
+}
+
+TEST(intrusive_list, auto_unlink_splice_rvalue) {
+  auto objects = std::vector<std::unique_ptr<unlinking>>();
+  for (auto i = 0; i < 6; i++) { objects.emplace_back(std::make_unique<unlinking>())->value = i; }
+  auto a = auto_unlink_list_type();
+  a.push_back(*objects[0]);
+  {
+    auto c = auto_unlink_list_type();
+    c.push_back(*objects[1]);
+    c.push_back(*objects[2]);
+    a.splice(a.end(), std::move(c));
+    EXPECT_TRUE(c.empty());
+  }
+  {
+    auto c = auto_unlink_list_type();
+    c.push_back(*objects[3]);
+    c.push_back(*objects[4]);
+    c.push_back(*objects[5]);
+    a.splice(a.begin(), std::move(c), std::next(c.begin()));
+    EXPECT_EQ(values_of(c), (std::vector<int>{3, 5}));
+    a.splice(a.end(), std::move(c), c.begin(), c.end());
+    EXPECT_TRUE(c.empty());
+  }
+  EXPECT_EQ(values_of(a), (std::vector<int>{4, 0, 1, 2, 3, 5}));
+  for (auto& object : objects) { EXPECT_TRUE(object->hook.is_linked()); }
+  objects.clear();
+  EXPECT_TRUE(a.empty());
+}
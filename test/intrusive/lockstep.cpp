@@ -0,0 +1,124 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This file is also built with the AVX2 and AVX-512 implementations enabled,
+// the tests are skipped if the CPU does not support them.
+
+#include "pleione/intrusive/lockstep.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+struct foo {
+  std::uint32_t key32 = 0;
+  char padding[100];
+  std::int64_t key64 = 0;
+  pleione::intrusive::forward_list_hook hook;
+};
+
+using list_type = pleione::intrusive::forward_list<foo, &foo::hook>;
+
+class intrusive_lockstep : public ::testing::Test {
+protected:
+  void SetUp() override {
+#if PLEIONE_LOCKSTEP_AVX512
+    if (!__builtin_cpu_supports("avx512f")) { GTEST_SKIP(); }
+#elif PLEIONE_LOCKSTEP_AVX2
+    if (!__builtin_cpu_supports("avx2")) { GTEST_SKIP(); }
+#endif
+  }
+};
+
+// Creates lists of random lengths with keys drawn from a small range, so that
+// some keys are repeated within a list, and picks keys that are present in
+// the list as well as ones that are not.
+static void make_batch(size_t n, std::vector<foo>& fs, std::vector<list_type>& lists,
+                       std::vector<std::int64_t>& keys) {
+  auto eng = std::default_random_engine(n);
+  auto length = std::uniform_int_distribution<size_t>(0, 20);
+  auto key = std::uniform_int_distribution<std::int64_t>(-10, 10);
+
+  auto lengths = std::vector<size_t>(n);
+  std::generate(lengths.begin(), lengths.end(), [&] { return length(eng); });
+  fs = std::vector<foo>(std::accumulate(lengths.begin(), lengths.end(), size_t(0)));
+  lists = std::vector<list_type>(n);
+  keys.clear();
+
+  auto next = fs.begin();
+  for (auto idx = 0u; idx < n; idx++) {
+    for (auto i = 0u; i < lengths[idx]; i++, ++next) {
+      next->key64 = key(eng);
+      next->key32 = std::uint32_t(next->key64);
+      lists[idx].push_front(*next);
+    }
+    keys.emplace_back(key(eng));
+  }
+}
+
+TEST_F(intrusive_lockstep, empty) {
+  auto lists = std::vector<list_type>();
+  auto keys = std::vector<std::int64_t>();
+  auto results = std::vector<foo*>();
+  auto end = pleione::intrusive::find_lockstep<&foo::key64>(lists.begin(), lists.end(), keys.begin(), results.begin());
+  EXPECT_EQ(end, results.end());
+}
+
+TEST_F(intrusive_lockstep, find_key64) {
+  for (auto n : {1u, 3u, 4u, 8u, 9u, 100u, 1000u}) {
+    auto fs = std::vector<foo>();
+    auto lists = std::vector<list_type>();
+    auto keys = std::vector<std::int64_t>();
+    make_batch(n, fs, lists, keys);
+
+    auto results = std::vector<foo*>(n, &fs[0]);
+    auto end =
+        pleione::intrusive::find_lockstep<&foo::key64>(lists.begin(), lists.end(), keys.begin(), results.begin());
+    EXPECT_EQ(end, results.end());
+    for (auto idx = 0u; idx < n; idx++) {
+      auto it = std::find_if(lists[idx].begin(), lists[idx].end(), [&](foo const& f) { return f.key64 == keys[idx]; });
+      EXPECT_EQ(results[idx], it == lists[idx].end() ? nullptr : &*it);
+    }
+  }
+}
+
+TEST_F(intrusive_lockstep, find_key32) {
+  for (auto n : {1u, 3u, 4u, 8u, 9u, 100u, 1000u}) {
+    auto fs = std::vector<foo>();
+    auto lists = std::vector<list_type>();
+    auto keys64 = std::vector<std::int64_t>();
+    make_batch(n, fs, lists, keys64);
+    auto keys = std::vector<std::uint32_t>(keys64.begin(), keys64.end());
+
+    auto results = std::vector<foo const*>(n);
+    auto const& const_lists = lists;
+    pleione::intrusive::find_lockstep<&foo::key32>(const_lists.begin(), const_lists.end(), keys.begin(),
+                                                   results.begin());
+    for (auto idx = 0u; idx < n; idx++) {
+      auto it = std::find_if(lists[idx].begin(), lists[idx].end(), [&](foo const& f) { return f.key32 == keys[idx]; });
+      EXPECT_EQ(results[idx], it == lists[idx].end() ? nullptr : &*it);
+    }
+  }
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <functional>
+#include <new>
+#include <numeric>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+struct foo {
+  int value = 0;
+  pleione::intrusive::offset_list_hook hook;
+  pleione::intrusive::offset_forward_list_hook forward_hook;
+};
+
+static_assert(sizeof(pleione::intrusive::offset_list_hook) == 2 * sizeof(void*));
+static_assert(std::is_trivially_default_constructible_v<pleione::intrusive::offset_list_hook>);
+
+using list_type = pleione::intrusive::list<foo, &foo::hook>;
+using forward_list_type = pleione::intrusive::forward_list<foo, &foo::forward_hook, true>;
+
+// The list headers are in the same mapping as their elements.
+struct region {
+  list_type list;
+  forward_list_type queue;
+  foo objects[64];
+};
+
+// The region is backed by a memfd mapped twice, at different addresses.
+class intrusive_offset : public ::testing::Test {
+protected:
+  int fd_ = -1;
+  region* first_ = nullptr;
+  region* second_ = nullptr;
+
+  static region* map(int fd) {
+    auto ptr = ::mmap(nullptr, sizeof(region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return ptr == MAP_FAILED ? nullptr : static_cast<region*>(ptr);
+  }
+
+  void SetUp() override {
+    fd_ = ::memfd_create("pleione_intrusive_offset", 0);
+    ASSERT_GE(fd_, 0);
+    ASSERT_EQ(::ftruncate(fd_, sizeof(region)), 0);
+    first_ = map(fd_);
+    second_ = map(fd_);
+    ASSERT_NE(first_, nullptr);
+    ASSERT_NE(second_, nullptr);
+    ASSERT_NE(first_, second_);
+    new (first_) region;
+    for (auto idx = 0; idx < 64; idx++) { first_->objects[idx].value = idx; }
+  }
+  void TearDown() override {
+    if (first_) {
+      first_->~region();
+      ::munmap(first_, sizeof(region));
+    }
+    if (second_) { ::munmap(second_, sizeof(region)); }
+    if (fd_ >= 0) { ::close(fd_); }
+  }
+};
+
+template<typename List> static std::vector<int> values(List const& list) {
+  auto result = std::vector<int>();
+  for (auto& f : list) { result.emplace_back(f.value); }
+  return result;
+}
+
+TEST_F(intrusive_offset, list) {
+  auto& l = first_->list;
+  auto& fs = first_->objects;
+  EXPECT_TRUE(l.empty());
+  EXPECT_TRUE(second_->list.empty());
+
+  l.push_back(fs[1]);
+  l.push_back(fs[2]);
+  l.push_front(fs[0]);
+  l.insert(std::next(l.begin()), fs + 10, fs + 13);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 10, 11, 12, 1, 2}));
+  EXPECT_EQ(values(second_->list), (std::vector<int>{0, 10, 11, 12, 1, 2}));
+  EXPECT_EQ(&second_->list.back(), &second_->objects[2]);
+  EXPECT_EQ(second_->list.size(), 6);
+
+  auto& other = second_->list;
+  other.erase(std::next(other.begin(), 2));
+  other.pop_front();
+  other.push_back(second_->objects[20]);
+  EXPECT_EQ(values(l), (std::vector<int>{10, 12, 1, 2, 20}));
+
+  l.sort([](foo const& a, foo const& b) { return a.value < b.value; });
+  EXPECT_EQ(values(other), (std::vector<int>{1, 2, 10, 12, 20}));
+
+  auto reversed = std::vector<int>();
+  for (auto it = other.rbegin(); it != other.rend(); ++it) { reversed.emplace_back(it->value); }
+  EXPECT_EQ(reversed, (std::vector<int>{20, 12, 10, 2, 1}));
+
+  auto sum = transform_reduce(other.begin(), other.end(), 0, std::plus<>{}, [](foo const& f) { return f.value; });
+  EXPECT_EQ(sum, 45);
+  EXPECT_EQ(&*find_if(pleione::prefetch<4>{}, other.begin(), other.end(), [](foo const& f) { return f.value > 5; }),
+            &second_->objects[10]);
+
+  l.clear();
+  EXPECT_TRUE(other.empty());
+}
+
+TEST_F(intrusive_offset, forward_list) {
+  auto& q = first_->queue;
+  auto& fs = first_->objects;
+  for (auto idx = 0; idx < 8; idx++) { q.push_back(fs[idx]); }
+  EXPECT_EQ(values(second_->queue), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+  EXPECT_EQ(&second_->queue.back(), &second_->objects[7]);
+
+  second_->queue.pop_front();
+  second_->queue.push_back(second_->objects[30]);
+  EXPECT_EQ(values(q), (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 30}));
+  EXPECT_EQ(&q.back(), &fs[30]);
+  EXPECT_EQ(q.size(), 8);
+
+  q.sort([](foo const& a, foo const& b) { return a.value > b.value; });
+  EXPECT_EQ(values(second_->queue), (std::vector<int>{30, 7, 6, 5, 4, 3, 2, 1}));
+  EXPECT_EQ(&second_->queue.back(), &second_->objects[1]);
+}
+
+TEST_F(intrusive_offset, move) {
+  auto& fs = first_->objects;
+  first_->list.assign(fs, fs + 4);
+  auto local = std::move(first_->list);
+  EXPECT_EQ(values(local), (std::vector<int>{0, 1, 2, 3}));
+  first_->list = std::move(local);
+  EXPECT_EQ(values(second_->list), (std::vector<int>{0, 1, 2, 3}));
+}
+
+// A producer and a consumer in separate processes share a queue. The child
+// maps the memfd again, so it sees the region at a different address.
+TEST_F(intrusive_offset, fork) {
+  auto& q = first_->queue;
+  auto& fs = first_->objects;
+  for (auto idx = 0; idx < 16; idx++) { q.push_back(fs[idx]); }
+
+  auto pid = ::fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    auto r = map(fd_);
+    auto ok = r && r != first_;
+    auto expected = 0;
+    while (ok && !r->queue.empty()) {
+      ok = r->queue.front().value == expected++;
+      r->queue.pop_front();
+    }
+    if (ok) {
+      for (auto idx = 40; idx < 44; idx++) { r->queue.push_back(r->objects[idx]); }
+      r->list.assign(r->objects + 50, r->objects + 53);
+    }
+    ::_exit(ok && expected == 16 ? 0 : 1);
+  }
+
+  auto status = 0;
+  ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_EQ(values(q), (std::vector<int>{40, 41, 42, 43}));
+  EXPECT_EQ(q.size(), 4);
+  EXPECT_EQ(&q.back(), &fs[43]);
+  EXPECT_EQ(values(first_->list), (std::vector<int>{50, 51, 52}));
+  EXPECT_EQ(values(second_->list), (std::vector<int>{50, 51, 52}));
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pleione::intrusive;
+
+struct foo {
+  int value = 0;
+  relocatable_list_hook hook;
+  relocatable_forward_list_hook forward_hook;
+
+  explicit foo(int v) noexcept : value(v) {}
+};
+
+static_assert(std::is_nothrow_move_constructible_v<foo>);
+static_assert(sizeof(relocatable_list_hook) == sizeof(list_hook));
+static_assert(sizeof(relocatable_forward_list_hook) == sizeof(forward_list_hook));
+
+using list_type = list<foo, &foo::hook>;
+using forward_list_type = forward_list<foo, &foo::forward_hook>;
+using tracked_forward_list_type = forward_list<foo, &foo::forward_hook, true>;
+
+template<typename List> static std::vector<int> values(List const& list) {
+  auto result = std::vector<int>();
+  for (auto& f : list) { result.emplace_back(f.value); }
+  return result;
+}
+
+template<typename List> static std::vector<int> reversed_values(List const& list) {
+  auto result = std::vector<int>();
+  for (auto it = list.rbegin(); it != list.rend(); ++it) { result.emplace_back(it->value); }
+  return result;
+}
+
+TEST(intrusive_relocatable_list_hook, is_linked) {
+  auto objects = std::vector<foo>();
+  objects.reserve(3);
+  for (auto i = 0; i < 3; ++i) { objects.emplace_back(i); }
+  EXPECT_FALSE(objects[0].hook.is_linked());
+
+  auto l = list_type(objects.begin(), objects.end());
+  EXPECT_TRUE(objects[0].hook.is_linked());
+  l.erase(l.begin());
+  EXPECT_FALSE(objects[0].hook.is_linked());
+  l.pop_back();
+  EXPECT_FALSE(objects[2].hook.is_linked());
+  l.push_back(objects[0]);
+  l.push_front(objects[2]);
+  l.pop_front();
+  EXPECT_FALSE(objects[2].hook.is_linked());
+  l.erase(l.begin(), l.end());
+  EXPECT_FALSE(objects[0].hook.is_linked());
+  EXPECT_FALSE(objects[1].hook.is_linked());
+
+  l.assign(objects.begin(), objects.end());
+  l.clear();
+  for (auto& f : objects) { EXPECT_FALSE(f.hook.is_linked()); }
+}
+
+TEST(intrusive_relocatable_list_hook, vector_growth) {
+  auto objects = std::vector<foo>();
+  auto l = list_type();
+  for (auto i = 0; i < 100; ++i) {
+    objects.emplace_back(i);
+    if (i % 3) {
+      l.push_front(objects.back());
+    } else {
+      l.push_back(objects.back());
+    }
+    if (i % 10 == 5) { l.erase(std::prev(l.end())); }
+  }
+
+  auto expected = std::vector<int>();
+  for (auto& f : objects) {
+    if (f.hook.is_linked()) { expected.emplace_back(f.value); }
+  }
+  auto actual = values(l);
+  EXPECT_EQ(actual.size(), l.size());
+  std::sort(actual.begin(), actual.end());
+  EXPECT_EQ(actual, expected);
+
+  auto reversed = values(l);
+  std::reverse(reversed.begin(), reversed.end());
+  EXPECT_EQ(reversed_values(l), reversed);
+  for (auto& f : l) { EXPECT_GE(&f, objects.data()); }
+  l.clear();
+}
+
+TEST(intrusive_relocatable_list_hook, move) {
+  auto objects = std::vector<foo>();
+  objects.reserve(4);
+  for (auto i = 0; i < 4; ++i) { objects.emplace_back(i); }
+  auto l = list_type(objects.begin(), objects.begin() + 3);
+
+  auto moved = foo(std::move(objects[1]));
+  EXPECT_FALSE(objects[1].hook.is_linked());
+  EXPECT_EQ(&*std::next(l.begin()), &moved);
+  EXPECT_EQ(reversed_values(l), (std::vector<int>{2, 1, 0}));
+
+  objects[3] = std::move(objects[2]);
+  EXPECT_FALSE(objects[2].hook.is_linked());
+  EXPECT_EQ(&l.back(), &objects[3]);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 1, 2}));
+
+  auto unlinked = foo(std::move(objects[2]));
+  EXPECT_FALSE(unlinked.hook.is_linked());
+  l.clear();
+}
+
+TEST(intrusive_relocatable_list_hook, vector_erase) {
+  auto objects = std::vector<foo>();
+  objects.reserve(5);
+  for (auto i = 0; i < 5; ++i) { objects.emplace_back(i); }
+  auto l = list_type();
+  for (auto it = objects.rbegin(); it != objects.rend(); ++it) { l.push_back(*it); }
+
+  l.erase(std::next(l.begin(), 3));
+  objects.erase(objects.begin() + 1);
+  EXPECT_EQ(values(l), (std::vector<int>{4, 3, 2, 0}));
+  EXPECT_EQ(&l.front(), &objects[3]);
+  EXPECT_EQ(&l.back(), &objects[0]);
+  l.clear();
+}
+
+TEST(intrusive_relocatable_list_hook, splice) {
+  auto objects = std::vector<foo>();
+  objects.reserve(5);
+  for (auto i = 0; i < 5; ++i) { objects.emplace_back(i); }
+  auto a = list_type(objects.begin(), objects.begin() + 2);
+  auto b = list_type(objects.begin() + 2, objects.end());
+
+  a.splice(a.end(), b);
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(values(a), (std::vector<int>{0, 1, 2, 3, 4}));
+  EXPECT_EQ(reversed_values(a), (std::vector<int>{4, 3, 2, 1, 0}));
+  for (auto& f : objects) { EXPECT_TRUE(f.hook.is_linked()); }
+
+  b.splice(b.begin(), a, std::next(a.begin()), std::prev(a.end()));
+  EXPECT_EQ(values(a), (std::vector<int>{0, 4}));
+  EXPECT_EQ(values(b), (std::vector<int>{1, 2, 3}));
+  b.splice(b.end(), a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(values(b), (std::vector<int>{1, 2, 3, 0, 4}));
+
+  b.erase(std::next(b.begin()));
+  objects.erase(objects.begin() + 2);
+  EXPECT_EQ(values(b), (std::vector<int>{1, 3, 0, 4}));
+  EXPECT_EQ(reversed_values(b), (std::vector<int>{4, 0, 3, 1}));
+  b.clear();
+  for (auto& f : objects) { EXPECT_FALSE(f.hook.is_linked()); }
+}
+
+TEST(intrusive_relocatable_list_hook, reassign) {
+  auto objects = std::vector<foo>();
+  objects.reserve(4);
+  for (auto i = 0; i < 4; ++i) { objects.emplace_back(i); }
+  auto l = list_type(objects.begin(), objects.begin() + 3);
+  l.assign(objects.begin() + 3, objects.end());
+  for (auto i = 0; i < 3; ++i) { EXPECT_FALSE(objects[i].hook.is_linked()); }
+  EXPECT_TRUE(objects[3].hook.is_linked());
+
+  objects.erase(objects.begin());
+  EXPECT_EQ(values(l), (std::vector<int>{3}));
+  EXPECT_EQ(&l.front(), &objects[2]);
+  l.clear();
+}
+
+TEST(intrusive_relocatable_forward_list_hook, vector_growth) {
+  auto objects = std::vector<foo>();
+  auto l = tracked_forward_list_type();
+  auto other = forward_list_type();
+  for (auto i = 0; i < 100; ++i) {
+    auto old = objects.data();
+    objects.emplace_back(i);
+    if (objects.data() != old) {
+      l.relink_after_move(old, old + objects.size() - 1, objects.data());
+      other.relink_after_move(old, old + objects.size() - 1, objects.data());
+    }
+    if (i % 2) {
+      l.push_back(objects.back());
+    } else {
+      other.push_front(objects.back());
+    }
+  }
+
+  auto odd = std::vector<int>();
+  auto even = std::vector<int>();
+  for (auto i = 0; i < 100; ++i) { (i % 2 ? odd : even).emplace_back(i); }
+  std::reverse(even.begin(), even.end());
+  EXPECT_EQ(values(l), odd);
+  EXPECT_EQ(values(other), even);
+  EXPECT_EQ(&l.back(), &objects.back());
+  EXPECT_EQ(l.size(), 50);
+}
+
+TEST(intrusive_relocatable_forward_list_hook, vector_erase) {
+  auto objects = std::vector<foo>();
+  objects.reserve(5);
+  for (auto i = 0; i < 5; ++i) { objects.emplace_back(i); }
+  auto l = tracked_forward_list_type();
+  for (auto it = objects.rbegin(); it != objects.rend(); ++it) { l.push_back(*it); }
+
+  l.erase_after(std::next(l.begin(), 2));
+  objects.erase(objects.begin() + 1);
+  l.relink_after_move(objects.data() + 2, objects.data() + 5, objects.data() + 1);
+  EXPECT_EQ(values(l), (std::vector<int>{4, 3, 2, 0}));
+  EXPECT_EQ(&l.front(), &objects[3]);
+  EXPECT_EQ(&l.back(), &objects[0]);
+  EXPECT_EQ(l.size(), 4);
+}
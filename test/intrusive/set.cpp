@@ -0,0 +1,255 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/set.hpp"
+
+#include <list>
+#include <random>
+#include <set>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+static_assert(std::is_trivially_default_constructible_v<pleione::intrusive::set_hook>);
+
+struct foo {
+  int value = 0;
+  pleione::intrusive::set_hook hook;
+
+  foo() = default;
+  explicit foo(int v) : value(v) {}
+
+  friend bool operator<(foo const& a, foo const& b) noexcept { return a.value < b.value; }
+  friend bool operator<(foo const& a, int b) noexcept { return a.value < b; }
+  friend bool operator<(int a, foo const& b) noexcept { return a < b.value; }
+};
+
+using set_type = pleione::intrusive::set<foo, &foo::hook, std::less<>>;
+using multiset_type = pleione::intrusive::multiset<foo, &foo::hook, std::less<>>;
+
+template<typename Set, typename ForwardIt> static void check_equal_range(Set& actual, ForwardIt first, ForwardIt last) {
+  EXPECT_EQ(actual.empty(), std::distance(first, last) == 0);
+  EXPECT_EQ(actual.size(), std::distance(first, last));
+  EXPECT_TRUE(std::equal(actual.begin(), actual.end(), first, last,
+                         [](foo const& a, foo const* b) { return &a == b; }));
+  EXPECT_TRUE(std::equal(actual.rbegin(), actual.rend(), std::make_reverse_iterator(last),
+                         std::make_reverse_iterator(first), [](foo const& a, foo const* b) { return &a == b; }));
+  if (first != last) {
+    EXPECT_EQ(&actual.front(), *first);
+    EXPECT_EQ(&actual.back(), *std::prev(last));
+  }
+}
+
+template<typename Set> static void check_empty(Set& actual) {
+  EXPECT_TRUE(actual.empty());
+  EXPECT_EQ(actual.size(), 0);
+  EXPECT_EQ(actual.begin(), actual.end());
+  EXPECT_EQ(actual.rbegin(), actual.rend());
+}
+
+static std::vector<foo const*> sorted_pointers(std::list<foo> const& fs) {
+  auto ptrs = std::vector<foo const*>();
+  for (auto& f : fs) { ptrs.emplace_back(&f); }
+  std::stable_sort(ptrs.begin(), ptrs.end(), [](foo const* a, foo const* b) { return *a < *b; });
+  return ptrs;
+}
+
+TEST(intrusive_set, default_constructor) {
+  auto s = set_type();
+  check_empty(s);
+  auto ms = multiset_type();
+  check_empty(ms);
+}
+
+TEST(intrusive_set, range_constructor) {
+  auto fs = std::list<foo>();
+  for (auto v : {5, 3, 8, 1, 9, 2, 7}) { fs.emplace_back(v); }
+  auto s = set_type(fs.begin(), fs.end());
+  auto expected = sorted_pointers(fs);
+  check_equal_range(s, expected.begin(), expected.end());
+}
+
+TEST(intrusive_set, insert_unique) {
+  auto fs = std::list<foo>();
+  auto s = set_type();
+  for (auto v : {4, 2, 6, 1, 3, 5, 7}) {
+    auto& f = fs.emplace_back(v);
+    auto [it, inserted] = s.insert(f);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(&*it, &f);
+  }
+  auto expected = sorted_pointers(fs);
+  check_equal_range(s, expected.begin(), expected.end());
+
+  auto dup = foo(3);
+  auto [it, inserted] = s.insert(dup);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->value, 3);
+  EXPECT_NE(&*it, &dup);
+  check_equal_range(s, expected.begin(), expected.end());
+}
+
+TEST(intrusive_set, insert_equal) {
+  auto fs = std::list<foo>();
+  auto s = multiset_type();
+  for (auto v : {2, 1, 2, 3, 2, 1, 3, 2}) {
+    auto& f = fs.emplace_back(v);
+    auto it = s.insert(f);
+    EXPECT_EQ(&*it, &f);
+  }
+  auto expected = sorted_pointers(fs);
+  check_equal_range(s, expected.begin(), expected.end());
+  EXPECT_EQ(s.count(2), 4);
+  EXPECT_EQ(s.count(1), 2);
+  EXPECT_EQ(s.count(4), 0);
+}
+
+TEST(intrusive_set, erase) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 16; i++) { fs.emplace_back(i); }
+  auto s = set_type(fs.begin(), fs.end());
+  for (auto it = fs.begin(); it != fs.end();) {
+    auto next = s.erase(*it);
+    if (std::next(it) != fs.end()) {
+      EXPECT_EQ(&*next, &*std::next(it));
+    } else {
+      EXPECT_EQ(next, s.end());
+    }
+    it = fs.erase(it);
+    auto expected = sorted_pointers(fs);
+    check_equal_range(s, expected.begin(), expected.end());
+  }
+  check_empty(s);
+}
+
+TEST(intrusive_set, erase_range) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 16; i++) { fs.emplace_back(i); }
+  auto s = set_type(fs.begin(), fs.end());
+  auto it = s.erase(s.find(4), s.find(12));
+  EXPECT_EQ(it->value, 12);
+  fs.erase(std::next(fs.begin(), 4), std::next(fs.begin(), 12));
+  auto expected = sorted_pointers(fs);
+  check_equal_range(s, expected.begin(), expected.end());
+  EXPECT_EQ(s.erase(s.begin(), s.end()), s.end());
+  check_empty(s);
+}
+
+TEST(intrusive_set, lookup) {
+  auto fs = std::list<foo>();
+  for (auto v : {10, 20, 20, 30, 40}) { fs.emplace_back(v); }
+  auto s = multiset_type(fs.begin(), fs.end());
+  multiset_type const& cs = s;
+
+  EXPECT_EQ(s.find(15), s.end());
+  EXPECT_EQ(s.find(20)->value, 20);
+  EXPECT_EQ(&*s.find(10), &fs.front());
+  EXPECT_EQ(cs.find(50), cs.end());
+  EXPECT_TRUE(s.contains(30));
+  EXPECT_FALSE(s.contains(35));
+
+  EXPECT_EQ(s.lower_bound(5), s.begin());
+  EXPECT_EQ(s.lower_bound(20), std::next(s.begin()));
+  EXPECT_EQ(s.upper_bound(20), std::next(s.begin(), 3));
+  EXPECT_EQ(cs.lower_bound(45), cs.end());
+  EXPECT_EQ(cs.upper_bound(40), cs.end());
+
+  auto [first, last] = s.equal_range(20);
+  EXPECT_EQ(std::distance(first, last), 2);
+  auto [cfirst, clast] = cs.equal_range(25);
+  EXPECT_EQ(cfirst, clast);
+}
+
+TEST(intrusive_set, iterators) {
+  static_assert(
+      std::is_base_of_v<std::bidirectional_iterator_tag, std::iterator_traits<set_type::iterator>::iterator_category>);
+  static_assert(std::is_same_v<std::iterator_traits<set_type::iterator>::value_type, foo>);
+  static_assert(std::is_same_v<std::iterator_traits<set_type::const_iterator>::value_type, foo const>);
+
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 16; i++) { fs.emplace_back(15 - i); }
+  auto s = set_type(fs.begin(), fs.end());
+
+  auto value = 0;
+  for (auto it = s.begin(); it != s.end(); it++) { EXPECT_EQ(it->value, value++); }
+  for (auto it = s.end(); it != s.begin();) { EXPECT_EQ((--it)->value, --value); }
+
+  set_type const& cs = s;
+  set_type::const_iterator cit = s.begin();
+  EXPECT_EQ(cit, cs.begin());
+  EXPECT_EQ(std::distance(cs.begin(), cs.end()), 16);
+
+  set_type::iterator it1{};
+  set_type::iterator it2{};
+  EXPECT_TRUE(it1 == it2);
+  EXPECT_FALSE(it1 != it2);
+}
+
+TEST(intrusive_set, move) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 8; i++) { fs.emplace_back(i); }
+  auto expected = sorted_pointers(fs);
+
+  auto s = set_type(fs.begin(), fs.end());
+  auto s2 = std::move(s);
+  check_empty(s);
+  check_equal_range(s2, expected.begin(), expected.end());
+
+  auto f = foo(100);
+  s.insert(f);
+  s = std::move(s2);
+  check_empty(s2);
+  check_equal_range(s, expected.begin(), expected.end());
+
+  using std::swap;
+  swap(s, s2);
+  check_empty(s);
+  check_equal_range(s2, expected.begin(), expected.end());
+}
+
+TEST(intrusive_set, random) {
+  auto eng = std::default_random_engine(0);
+  auto dist = std::uniform_int_distribution<int>(0, 256);
+
+  auto fs = std::list<foo>();
+  auto reference = std::multiset<int>();
+  auto s = multiset_type();
+  for (auto i = 0; i < 4096; i++) {
+    if (fs.empty() || dist(eng) % 3) {
+      auto& f = fs.emplace_back(dist(eng));
+      s.insert(f);
+      reference.emplace(f.value);
+    } else {
+      auto it = std::next(fs.begin(), dist(eng) % fs.size());
+      s.erase(*it);
+      reference.erase(reference.find(it->value));
+      fs.erase(it);
+    }
+    ASSERT_EQ(s.size(), reference.size());
+    if (i % 64 == 0) {
+      EXPECT_TRUE(std::equal(s.begin(), s.end(), reference.begin(), reference.end(),
+                             [](foo const& a, int b) { return a.value == b; }));
+      EXPECT_TRUE(std::equal(s.rbegin(), s.rend(), reference.rbegin(), reference.rend(),
+                             [](foo const& a, int b) { return a.value == b; }));
+    }
+  }
+}
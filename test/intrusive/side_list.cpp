@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/side_list.hpp"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+struct foo {
+  int value = 0;
+};
+
+using hook_type = pleione::intrusive::side_list_hook<int>;
+using list_type = pleione::intrusive::side_list<foo, int>;
+
+static_assert(sizeof(hook_type) == 3 * sizeof(std::uint32_t));
+
+template<typename List> static std::vector<int> values(List const& list) {
+  auto result = std::vector<int>();
+  for (auto& f : list) { result.emplace_back(f.value); }
+  return result;
+}
+
+template<typename List> static std::vector<int> keys(List const& list) {
+  auto result = std::vector<int>();
+  for (auto it = list.begin(); it != list.end(); ++it) { result.emplace_back(it.key()); }
+  return result;
+}
+
+class intrusive_side_list : public ::testing::Test {
+protected:
+  std::array<foo, 8> objects_;
+  std::array<hook_type, 8> hooks_;
+
+  void SetUp() override {
+    for (auto i = 0u; i < objects_.size(); ++i) { objects_[i].value = int(i); }
+  }
+};
+
+TEST_F(intrusive_side_list, empty) {
+  auto l = list_type(objects_.data(), hooks_.data());
+  EXPECT_TRUE(l.empty());
+  EXPECT_EQ(l.size(), 0);
+  EXPECT_EQ(l.begin(), l.end());
+  EXPECT_EQ(l.find(0), l.end());
+}
+
+TEST_F(intrusive_side_list, push_pop) {
+  auto l = list_type(objects_.data(), hooks_.data());
+  l.push_back(objects_[2], 20);
+  l.push_back(objects_[5], 50);
+  l.push_front(objects_[7], 70);
+  EXPECT_EQ(l.size(), 3);
+  EXPECT_EQ(values(l), (std::vector<int>{7, 2, 5}));
+  EXPECT_EQ(keys(l), (std::vector<int>{70, 20, 50}));
+  EXPECT_EQ(&l.front(), &objects_[7]);
+  EXPECT_EQ(&l.back(), &objects_[5]);
+  EXPECT_EQ(l.key(objects_[2]), 20);
+
+  l.pop_front();
+  EXPECT_EQ(values(l), (std::vector<int>{2, 5}));
+  l.pop_back();
+  EXPECT_EQ(values(l), (std::vector<int>{2}));
+  EXPECT_EQ(&l.back(), &objects_[2]);
+  l.pop_back();
+  EXPECT_TRUE(l.empty());
+  EXPECT_EQ(l.begin(), l.end());
+}
+
+TEST_F(intrusive_side_list, insert_erase) {
+  auto l = list_type(objects_.data(), hooks_.data());
+  auto it = l.insert(l.end(), objects_[1], 10);
+  EXPECT_EQ(it.slot(), 1);
+  l.insert(it, objects_[0], 0);
+  l.insert(l.end(), objects_[3], 30);
+  l.insert(l.iterator_to(objects_[3]), objects_[2], 20);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 1, 2, 3}));
+
+  auto next = l.erase(objects_[1]);
+  EXPECT_EQ(&*next, &objects_[2]);
+  EXPECT_EQ(values(l), (std::vector<int>{0, 2, 3}));
+  EXPECT_EQ(l.erase(l.iterator_to(objects_[3])), l.end());
+  EXPECT_EQ(&l.back(), &objects_[2]);
+  l.erase(l.begin());
+  EXPECT_EQ(&l.front(), &objects_[2]);
+  EXPECT_EQ(l.size(), 1);
+}
+
+TEST_F(intrusive_side_list, find) {
+  auto l = list_type(objects_.data(), hooks_.data());
+  for (auto& f : objects_) { l.push_back(f, f.value * 10); }
+  auto it = l.find(40);
+  ASSERT_NE(it, l.end());
+  EXPECT_EQ(&*it, &objects_[4]);
+  EXPECT_EQ(it->value, 4);
+  EXPECT_EQ(l.find(45), l.end());
+
+  auto const& cl = l;
+  EXPECT_EQ(&*cl.find(70), &objects_[7]);
+  EXPECT_EQ(cl.find(40), list_type::const_iterator(it));
+}
+
+TEST_F(intrusive_side_list, shared_arrays) {
+  auto even = list_type(objects_.data(), hooks_.data());
+  auto odd = list_type(objects_.data(), hooks_.data());
+  for (auto& f : objects_) { (f.value % 2 ? odd : even).push_front(f, f.value); }
+  EXPECT_EQ(values(even), (std::vector<int>{6, 4, 2, 0}));
+  EXPECT_EQ(values(odd), (std::vector<int>{7, 5, 3, 1}));
+
+  odd.erase(objects_[3]);
+  even.push_back(objects_[3], 3);
+  EXPECT_EQ(values(even), (std::vector<int>{6, 4, 2, 0, 3}));
+  EXPECT_EQ(values(odd), (std::vector<int>{7, 5, 1}));
+
+  auto moved = std::move(odd);
+  EXPECT_TRUE(odd.empty());
+  EXPECT_EQ(values(moved), (std::vector<int>{7, 5, 1}));
+}
+
+TEST_F(intrusive_side_list, algorithms) {
+  auto l = list_type(objects_.data(), hooks_.data());
+  for (auto& f : objects_) { l.push_back(f, f.value); }
+
+  auto sum = 0;
+  for_each(l.begin(), l.end(), [&](foo& f) { sum += f.value; });
+  EXPECT_EQ(sum, 28);
+  sum = 0;
+  for_each(pleione::prefetch<4>::members<&foo::value>{}, l.begin(), l.end(), [&](foo& f) { sum += f.value; });
+  EXPECT_EQ(sum, 28);
+
+  auto const& cl = l;
+  auto total = transform_reduce(pleione::prefetch<2>::object{}, cl.begin(), cl.end(), 0, std::plus<>{},
+                                [](foo const& f) { return f.value; });
+  EXPECT_EQ(total, 28);
+
+  auto it = find_if(pleione::prefetch<false>{}, l.begin(), l.end(), [](foo const& f) { return f.value == 5; });
+  EXPECT_EQ(&*it, &objects_[5]);
+  EXPECT_EQ(find_if(l.begin(), l.end(), [](foo const&) { return false; }), l.end());
+}
+
+TEST(intrusive_side_list_key, non_trivial_key) {
+  auto objects = std::vector<foo>(3);
+  auto hooks = std::vector<pleione::intrusive::side_list_hook<std::string>>(objects.size());
+  auto l = pleione::intrusive::side_list<foo, std::string>(objects.data(), hooks.data());
+  l.push_back(objects[0], "a");
+  l.push_back(objects[1], "b");
+  l.push_back(objects[2], "c");
+  EXPECT_EQ(&*l.find("b"), &objects[1]);
+  EXPECT_EQ(l.key(objects[2]), "c");
+}
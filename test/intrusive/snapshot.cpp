@@ -0,0 +1,166 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/forward_list.hpp"
+#include "pleione/intrusive/list.hpp"
+#include "pleione/intrusive/snapshot.hpp"
+
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+struct foo {
+  int value = 0;
+  pleione::intrusive::offset_list_hook hook;
+  pleione::intrusive::offset_forward_list_hook forward_hook;
+};
+
+using list_type = pleione::intrusive::list<foo, &foo::hook>;
+using forward_list_type = pleione::intrusive::forward_list<foo, &foo::forward_hook, true>;
+
+struct root {
+  list_type list;
+  forward_list_type queue;
+};
+
+class intrusive_snapshot : public ::testing::Test {
+protected:
+  std::string path_ = ::testing::TempDir() + "pleione_intrusive_snapshot";
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  // Saves a snapshot with elements 0..n-1 in the list and the even ones in
+  // the queue, in reverse order.
+  void save(int n) {
+    auto s = pleione::intrusive::snapshot::create(sizeof(root) + n * sizeof(foo));
+    ASSERT_TRUE(s);
+    auto r = s->construct<root>();
+    ASSERT_NE(r, nullptr);
+    s->set_root(*r);
+    auto objects = s->construct_n<foo>(n);
+    ASSERT_NE(objects, nullptr);
+    for (auto idx = 0; idx < n; idx++) {
+      objects[idx].value = idx;
+      r->list.push_back(objects[idx]);
+      if (idx % 2 == 0) { r->queue.push_front(objects[idx]); }
+    }
+    EXPECT_EQ(s->construct<foo>(), nullptr);
+    ASSERT_TRUE(s->save(path_.c_str()));
+  }
+};
+
+template<typename List> static std::vector<int> values(List const& list) {
+  auto result = std::vector<int>();
+  for (auto& f : list) { result.emplace_back(f.value); }
+  return result;
+}
+
+TEST_F(intrusive_snapshot, create) {
+  auto s = pleione::intrusive::snapshot::create(1024);
+  ASSERT_TRUE(s);
+  EXPECT_EQ(s->root<root>(), nullptr);
+  EXPECT_EQ(s->size(), 64);
+  EXPECT_GE(s->capacity(), 1024);
+
+  auto a = s->allocate(1, 1);
+  auto b = s->allocate(8, 8);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0);
+  EXPECT_EQ(static_cast<std::byte*>(b) - s->data(), 72);
+  EXPECT_EQ(s->size(), 80);
+  EXPECT_EQ(s->allocate(4096, 1), nullptr);
+  EXPECT_EQ(s->size(), 80);
+
+  auto moved = std::move(*s);
+  EXPECT_EQ(s->data(), nullptr);
+  EXPECT_EQ(moved.size(), 80);
+}
+
+TEST_F(intrusive_snapshot, reload) {
+  save(100);
+
+  for (auto mode : {pleione::intrusive::snapshot_load::lazy, pleione::intrusive::snapshot_load::populate}) {
+    auto s = pleione::intrusive::snapshot::load(path_.c_str(), mode);
+    ASSERT_TRUE(s);
+    auto r = s->root<root>();
+    ASSERT_NE(r, nullptr);
+
+    auto expected = std::vector<int>(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(values(r->list), expected);
+    EXPECT_EQ(r->list.size(), 100);
+    EXPECT_EQ(r->list.back().value, 99);
+    EXPECT_EQ(std::prev(r->list.end())->value, 99);
+
+    auto even = std::vector<int>();
+    for (auto idx = 98; idx >= 0; idx -= 2) { even.emplace_back(idx); }
+    EXPECT_EQ(values(r->queue), even);
+    EXPECT_EQ(r->queue.back().value, 0);
+    EXPECT_EQ(r->queue.size(), 50);
+
+    EXPECT_EQ(s->construct<foo>(), nullptr);
+  }
+}
+
+TEST_F(intrusive_snapshot, modify_loaded) {
+  save(10);
+
+  {
+    auto s = pleione::intrusive::snapshot::load(path_.c_str());
+    ASSERT_TRUE(s);
+    auto r = s->root<root>();
+    r->list.sort([](foo const& a, foo const& b) { return a.value > b.value; });
+    r->queue.pop_front();
+    EXPECT_EQ(values(r->list), (std::vector<int>{9, 8, 7, 6, 5, 4, 3, 2, 1, 0}));
+    EXPECT_EQ(values(r->queue), (std::vector<int>{6, 4, 2, 0}));
+
+    auto again = pleione::intrusive::snapshot::load(path_.c_str());
+    ASSERT_TRUE(again);
+    EXPECT_EQ(values(again->root<root>()->list), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    ASSERT_TRUE(s->save(path_.c_str()));
+  }
+
+  auto s = pleione::intrusive::snapshot::load(path_.c_str());
+  ASSERT_TRUE(s);
+  EXPECT_EQ(values(s->root<root>()->list), (std::vector<int>{9, 8, 7, 6, 5, 4, 3, 2, 1, 0}));
+  EXPECT_EQ(values(s->root<root>()->queue), (std::vector<int>{6, 4, 2, 0}));
+}
+
+TEST_F(intrusive_snapshot, invalid) {
+  EXPECT_FALSE(pleione::intrusive::snapshot::load(path_.c_str()));
+
+  auto f = std::fopen(path_.c_str(), "wb");
+  ASSERT_NE(f, nullptr);
+  auto garbage = std::vector<char>(256, 'x');
+  std::fwrite(garbage.data(), 1, garbage.size(), f);
+  std::fclose(f);
+  EXPECT_FALSE(pleione::intrusive::snapshot::load(path_.c_str()));
+
+  save(4);
+  ASSERT_EQ(::truncate(path_.c_str(), 100), 0);
+  EXPECT_FALSE(pleione::intrusive::snapshot::load(path_.c_str()));
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright © 2019 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/unordered_set.hpp"
+
+#include <list>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+struct foo {
+  int id = 0;
+  pleione::intrusive::forward_list_hook hook;
+
+  foo() = default;
+  explicit foo(int v) : id(v) {}
+};
+
+struct foo_id {
+  int operator()(foo const& f) const noexcept { return f.id; }
+};
+
+using set_type = pleione::intrusive::unordered_set<foo, &foo::hook, foo_id>;
+
+static void check_contents(set_type const& actual, std::list<foo> const& expected) {
+  EXPECT_EQ(actual.empty(), expected.empty());
+  EXPECT_EQ(actual.size(), expected.size());
+  EXPECT_EQ(std::distance(actual.begin(), actual.end()), expected.size());
+  auto visited = std::unordered_map<foo const*, int>();
+  for (auto& f : actual) { visited[&f]++; }
+  EXPECT_EQ(visited.size(), expected.size());
+  for (auto& f : expected) {
+    EXPECT_EQ(visited[&f], 1);
+    EXPECT_EQ(&*actual.find(f.id), &f);
+  }
+}
+
+TEST(intrusive_unordered_set, default_constructor) {
+  auto s = set_type();
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.size(), 0);
+  EXPECT_EQ(s.bucket_count(), 0);
+  EXPECT_EQ(s.begin(), s.end());
+  EXPECT_EQ(s.find(1), s.end());
+  EXPECT_EQ(s.erase(1), 0);
+}
+
+TEST(intrusive_unordered_set, bucket_count_constructor) {
+  auto s = set_type(100);
+  EXPECT_EQ(s.bucket_count(), 128);
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.begin(), s.end());
+}
+
+TEST(intrusive_unordered_set, insert) {
+  auto fs = std::list<foo>();
+  auto s = set_type();
+  for (auto i = 0; i < 100; i++) {
+    auto& f = fs.emplace_back(i * 7);
+    auto [it, inserted] = s.insert(f);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(&*it, &f);
+    check_contents(s, fs);
+  }
+  EXPECT_EQ(s.bucket_count() & (s.bucket_count() - 1), 0);
+  EXPECT_LE(s.load_factor(), 1.f);
+
+  auto dup = foo(21);
+  auto [it, inserted] = s.insert(dup);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(&*it, &*std::next(fs.begin(), 3));
+  check_contents(s, fs);
+}
+
+TEST(intrusive_unordered_set, range_insert) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 64; i++) { fs.emplace_back(i); }
+  auto s = set_type();
+  s.insert(fs.begin(), fs.end());
+  check_contents(s, fs);
+}
+
+TEST(intrusive_unordered_set, erase) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 64; i++) { fs.emplace_back(i); }
+  auto s = set_type();
+  s.insert(fs.begin(), fs.end());
+
+  s.erase(fs.front());
+  fs.pop_front();
+  check_contents(s, fs);
+
+  EXPECT_EQ(s.erase(fs.front().id), 1);
+  EXPECT_EQ(s.erase(1000), 0);
+  fs.pop_front();
+  check_contents(s, fs);
+
+  auto it = s.find(fs.back().id);
+  auto next = std::next(it);
+  EXPECT_EQ(s.erase(it), next);
+  fs.pop_back();
+  check_contents(s, fs);
+
+  for (auto it = s.begin(); it != s.end();) { it = s.erase(it); }
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.begin(), s.end());
+}
+
+TEST(intrusive_unordered_set, clear) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 64; i++) { fs.emplace_back(i); }
+  auto s = set_type();
+  s.insert(fs.begin(), fs.end());
+  s.clear();
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.begin(), s.end());
+  EXPECT_EQ(s.find(3), s.end());
+  s.insert(fs.begin(), fs.end());
+  check_contents(s, fs);
+}
+
+TEST(intrusive_unordered_set, reserve) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 64; i++) { fs.emplace_back(i); }
+  auto s = set_type();
+  s.insert(fs.begin(), fs.end());
+  s.reserve(1000);
+  EXPECT_EQ(s.bucket_count(), 1024);
+  check_contents(s, fs);
+  s.reserve(10);
+  EXPECT_EQ(s.bucket_count(), 1024);
+}
+
+TEST(intrusive_unordered_set, move) {
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 20; i++) { fs.emplace_back(i); }
+  auto s = set_type();
+  s.insert(fs.begin(), fs.end());
+
+  auto s2 = std::move(s);
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.begin(), s.end());
+  check_contents(s2, fs);
+
+  auto f = foo(100);
+  s.insert(f);
+  s = std::move(s2);
+  EXPECT_TRUE(s2.empty());
+  check_contents(s, fs);
+}
+
+TEST(intrusive_unordered_set, iterators) {
+  static_assert(
+      std::is_base_of_v<std::forward_iterator_tag, std::iterator_traits<set_type::iterator>::iterator_category>);
+  static_assert(std::is_same_v<std::iterator_traits<set_type::iterator>::value_type, foo>);
+  static_assert(std::is_same_v<std::iterator_traits<set_type::const_iterator>::value_type, foo const>);
+
+  auto fs = std::list<foo>();
+  for (auto i = 0; i < 16; i++) { fs.emplace_back(i); }
+  auto s = set_type();
+  s.insert(fs.begin(), fs.end());
+
+  set_type const& cs = s;
+  set_type::const_iterator cit = s.begin();
+  EXPECT_EQ(cit, cs.begin());
+  EXPECT_EQ(cs.find(3)->id, 3);
+  EXPECT_EQ(cs.count(3), 1);
+  EXPECT_FALSE(cs.contains(16));
+
+  set_type::iterator it1{};
+  set_type::iterator it2{};
+  EXPECT_TRUE(it1 == it2);
+  EXPECT_FALSE(it1 != it2);
+}
+
+TEST(intrusive_unordered_set, random) {
+  auto eng = std::default_random_engine(0);
+  auto dist = std::uniform_int_distribution<int>(0, 1 << 20);
+
+  auto fs = std::list<foo>();
+  auto reference = std::unordered_map<int, foo*>();
+  auto s = set_type();
+  for (auto i = 0; i < 8192; i++) {
+    if (fs.empty() || dist(eng) % 4) {
+      auto& f = fs.emplace_back(dist(eng));
+      auto inserted = s.insert(f).second;
+      EXPECT_EQ(inserted, reference.emplace(f.id, &f).second);
+      if (!inserted) { fs.pop_back(); }
+    } else {
+      auto it = std::next(fs.begin(), dist(eng) % fs.size());
+      s.erase(*it);
+      reference.erase(it->id);
+      fs.erase(it);
+    }
+    ASSERT_EQ(s.size(), reference.size());
+    if (i % 256 == 0) { check_contents(s, fs); }
+  }
+  check_contents(s, fs);
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright © 2018 Paweł Dziepak
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pleione/intrusive/xor_list.hpp"
+
+#include <functional>
+#include <list>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static_assert(std::is_trivially_default_constructible_v<pleione::intrusive::xor_list_hook>);
+static_assert(sizeof(pleione::intrusive::xor_list_hook) == sizeof(void*));
+
+struct foo {
+  int value;
+  pleione::intrusive::xor_list_hook hook;
+
+  friend bool operator==(foo const& a, foo const& b) noexcept { return &a == &b; }
+};
+
+using list_type = pleione::intrusive::xor_list<foo, &foo::hook>;
+
+template<typename List, typename ForwardIt>
+static void check_equal_range(List& actual, ForwardIt first, ForwardIt last) {
+  EXPECT_EQ(actual.empty(), std::distance(first, last) == 0);
+  EXPECT_EQ(actual.size(), std::distance(first, last));
+  EXPECT_EQ(std::distance(actual.begin(), actual.end()), std::distance(first, last));
+  EXPECT_TRUE(std::equal(actual.begin(), actual.end(), first, last));
+  EXPECT_TRUE(std::equal(actual.rbegin(), actual.rend(), std::make_reverse_iterator(last),
+                         std::make_reverse_iterator(first)));
+  if (first != last) {
+    EXPECT_EQ(actual.front(), *first);
+    EXPECT_EQ(actual.back(), *std::prev(last));
+  }
+}
+
+template<typename List, typename Range> static void check_equal_range(List& actual, Range&& range) {
+  check_equal_range(actual, range.begin(), range.end());
+}
+
+template<typename List> static void check_empty(List& actual) {
+  EXPECT_TRUE(actual.empty());
+  EXPECT_EQ(actual.size(), 0);
+  EXPECT_EQ(actual.begin(), actual.end());
+  EXPECT_EQ(actual.rbegin(), actual.rend());
+}
+
+TEST(intrusive_xor_list, default_constructor) {
+  auto l = list_type();
+  check_empty(l);
+}
+
+TEST(intrusive_xor_list, range_constructor) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  check_equal_range(l, fs);
+}
+
+TEST(intrusive_xor_list, move) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  auto l2 = std::move(l);
+  check_empty(l);
+  check_equal_range(l2, fs);
+  l = std::move(l2);
+  check_empty(l2);
+  check_equal_range(l, fs);
+}
+
+TEST(intrusive_xor_list, push_pop) {
+  auto fs = std::vector<foo>(4);
+  auto l = list_type();
+  l.push_back(fs[1]);
+  l.push_front(fs[0]);
+  l.push_back(fs[2]);
+  l.push_back(fs[3]);
+  check_equal_range(l, fs);
+
+  l.pop_front();
+  check_equal_range(l, fs.begin() + 1, fs.end());
+  l.pop_back();
+  check_equal_range(l, fs.begin() + 1, fs.end() - 1);
+  l.pop_back();
+  l.pop_front();
+  check_empty(l);
+}
+
+TEST(intrusive_xor_list, insert_erase) {
+  auto fs = std::vector<foo>(5);
+  auto l = list_type();
+  auto it = l.insert(l.end(), fs[4]);
+  EXPECT_EQ(&*it, &fs[4]);
+  it = l.insert(l.begin(), fs[0]);
+  EXPECT_EQ(&*it, &fs[0]);
+  it = l.insert(std::prev(l.end()), fs[2]);
+  EXPECT_EQ(&*it, &fs[2]);
+  l.insert(std::next(l.begin(), 2), fs[3]);
+  l.insert(std::next(l.begin()), fs[1]);
+  check_equal_range(l, fs);
+
+  it = l.erase(std::next(l.begin(), 2));
+  EXPECT_EQ(&*it, &fs[3]);
+  it = l.erase(it);
+  EXPECT_EQ(&*it, &fs[4]);
+  it = l.erase(it);
+  EXPECT_EQ(it, l.end());
+  check_equal_range(l, fs.begin(), fs.begin() + 2);
+  it = l.erase(l.begin());
+  EXPECT_EQ(&*it, &fs[1]);
+  it = l.erase(it);
+  EXPECT_EQ(it, l.end());
+  check_empty(l);
+}
+
+TEST(intrusive_xor_list, splice) {
+  auto fs = std::vector<foo>(8);
+  for (auto position : {0, 1, 3, 4}) {
+    auto l = list_type(fs.begin(), fs.begin() + 4);
+    auto other = list_type(fs.begin() + 4, fs.end());
+    l.splice(std::next(l.begin(), position), other);
+    check_empty(other);
+
+    auto expected = std::list<std::reference_wrapper<foo>>(fs.begin(), fs.begin() + 4);
+    expected.insert(std::next(expected.begin(), position), fs.begin() + 4, fs.end());
+    check_equal_range(l, expected);
+  }
+
+  auto l = list_type();
+  auto single = list_type(fs.begin(), fs.begin() + 1);
+  l.splice(l.end(), std::move(single));
+  check_equal_range(l, fs.begin(), fs.begin() + 1);
+  l.splice(l.begin(), list_type());
+  check_equal_range(l, fs.begin(), fs.begin() + 1);
+  auto other = list_type(fs.begin() + 1, fs.begin() + 2);
+  l.splice(l.begin(), other);
+  EXPECT_EQ(&l.front(), &fs[1]);
+  EXPECT_EQ(&l.back(), &fs[0]);
+}
+
+TEST(intrusive_xor_list, reverse) {
+  auto fs = std::vector<foo>(8);
+  auto l = list_type(fs.begin(), fs.end());
+  l.reverse();
+  check_equal_range(l, fs.rbegin(), fs.rend());
+  auto extra = foo();
+  l.push_back(extra);
+  l.erase(std::prev(l.end()));
+  l.reverse();
+  check_equal_range(l, fs);
+}
+
+TEST(intrusive_xor_list, iterators) {
+  auto fs = std::vector<foo>(4);
+  auto l = list_type(fs.begin(), fs.end());
+  auto const& cl = l;
+
+  auto it = l.begin();
+  auto cit = list_type::const_iterator(it);
+  EXPECT_EQ(&*cit, &fs[0]);
+  EXPECT_EQ(&*it++, &fs[0]);
+  EXPECT_EQ(&*it, &fs[1]);
+  EXPECT_EQ(&*++it, &fs[2]);
+  EXPECT_EQ(&*it--, &fs[2]);
+  EXPECT_EQ(&*--it, &fs[0]);
+  EXPECT_EQ(it, l.begin());
+  EXPECT_EQ(std::prev(l.end())->value, fs[3].value);
+  EXPECT_EQ(&*std::prev(cl.end()), &fs[3]);
+  EXPECT_EQ(std::next(cl.begin(), 4), cl.end());
+}
+
+TEST(intrusive_xor_list, algorithms) {
+  auto fs = std::vector<foo>(100);
+  for (auto idx = 0; idx < 100; idx++) { fs[idx].value = idx; }
+  auto l = list_type(fs.begin(), fs.end());
+
+  auto visited = std::vector<int>();
+  for_each(l.begin(), l.end(), [&](foo& f) { visited.emplace_back(f.value); });
+  auto expected = std::vector<int>(100);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(visited, expected);
+
+  visited.clear();
+  for_each(pleione::prefetch<4>{}, std::next(l.begin(), 10), std::prev(l.end(), 10),
+           [&](foo const& f) { visited.emplace_back(f.value); });
+  EXPECT_EQ(visited, std::vector<int>(expected.begin() + 10, expected.end() - 10));
+
+  auto sum = [](auto first, auto last) {
+    return transform_reduce(first, last, 0, std::plus<>{}, [](foo const& f) { return f.value; });
+  };
+  EXPECT_EQ(sum(l.begin(), l.end()), 4950);
+  EXPECT_EQ(sum(std::next(l.begin()), l.end()), 4950);
+  EXPECT_EQ(sum(l.begin(), std::next(l.begin())), 0);
+  EXPECT_EQ(sum(std::next(l.begin(), 5), std::next(l.begin(), 8)), 18);
+  EXPECT_EQ(sum(l.end(), l.end()), 0);
+
+  EXPECT_EQ(&*find_if(l.begin(), l.end(), [](foo const& f) { return f.value == 42; }), &fs[42]);
+  EXPECT_EQ(find_if(pleione::prefetch<8>{}, l.begin(), l.end(), [](foo const& f) { return f.value < 0; }), l.end());
+}
+
+TEST(intrusive_xor_list, random_operations) {
+  auto fs = std::vector<foo>(64);
+  auto l = list_type();
+  auto expected = std::list<std::reference_wrapper<foo>>();
+  auto unlinked = std::vector<foo*>();
+  for (auto& f : fs) { unlinked.emplace_back(&f); }
+
+  auto eng = std::default_random_engine(0);
+  for (auto step = 0; step < 10000; step++) {
+    auto operation = std::uniform_int_distribution<int>(0, 5)(eng);
+    auto position = std::uniform_int_distribution<size_t>(0, expected.size())(eng);
+    if (operation < 3 && !unlinked.empty()) {
+      auto& f = *unlinked.back();
+      unlinked.pop_back();
+      if (operation == 0) {
+        l.push_front(f);
+        expected.emplace_front(f);
+      } else if (operation == 1) {
+        l.push_back(f);
+        expected.emplace_back(f);
+      } else {
+        l.insert(std::next(l.begin(), position), f);
+        expected.insert(std::next(expected.begin(), position), f);
+      }
+    } else if (operation < 5 && !expected.empty()) {
+      position = std::min(position, expected.size() - 1);
+      unlinked.emplace_back(&*std::next(l.begin(), position));
+      l.erase(std::next(l.begin(), position));
+      expected.erase(std::next(expected.begin(), position));
+    } else if (operation == 5) {
+      l.reverse();
+      expected.reverse();
+    }
+    ASSERT_EQ(l.size(), expected.size());
+  }
+  check_equal_range(l, expected);
+}